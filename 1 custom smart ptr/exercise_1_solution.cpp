@@ -1,6 +1,15 @@
 #include <iostream>
 #include <type_traits>
 #include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+#include "../common/tracing.h"
 
 // Helper type trait to detect if T is an array type
 template<typename T>
@@ -12,27 +21,75 @@ struct is_array_type<T[]> : std::true_type {};
 template<typename T, size_t N>
 struct is_array_type<T[N]> : std::true_type {};
 
-// Primary template for single objects
+// Default deleters (stateless, so they take no space inside UniquePtr)
 template<typename T>
-class UniquePtr {
+struct DefaultDelete {
+    void operator()(T* ptr) const noexcept {
+        delete ptr;
+    }
+};
+
+template<typename T>
+struct DefaultDelete<T[]> {
+    void operator()(T* ptr) const noexcept {
+        delete[] ptr;
+    }
+};
+
+// Stores the deleter; empty deleters are stored as a base class so the
+// empty base optimization keeps sizeof(UniquePtr) equal to one pointer
+template<typename Deleter, bool = std::is_empty_v<Deleter> && !std::is_final_v<Deleter>>
+class DeleterHolder {
+private:
+    Deleter deleter_;
+
+public:
+    DeleterHolder() = default;
+    explicit DeleterHolder(Deleter d) noexcept : deleter_(std::move(d)) {}
+
+    Deleter& deleter() noexcept { return deleter_; }
+    const Deleter& deleter() const noexcept { return deleter_; }
+};
+
+template<typename Deleter>
+class DeleterHolder<Deleter, true> : private Deleter {
+public:
+    DeleterHolder() = default;
+    explicit DeleterHolder(Deleter d) noexcept : Deleter(std::move(d)) {}
+
+    Deleter& deleter() noexcept { return *this; }
+    const Deleter& deleter() const noexcept { return *this; }
+};
+
+// Primary template for single objects
+template<typename T, typename Deleter = DefaultDelete<T>>
+class UniquePtr : private DeleterHolder<Deleter> {
 private:
     T* ptr_;
 
+    using Holder = DeleterHolder<Deleter>;
+
 public:
     // Type aliases
     using element_type = T;
     using pointer = T*;
+    using deleter_type = Deleter;
 
     // Default constructor (nullptr)
     explicit UniquePtr(pointer ptr = nullptr) noexcept : ptr_(ptr) {}
 
+    // Constructor with a custom deleter instance
+    UniquePtr(pointer ptr, Deleter deleter) noexcept : Holder(std::move(deleter)), ptr_(ptr) {}
+
     // Move constructor
-    UniquePtr(UniquePtr&& other) noexcept : ptr_(other.release()) {}
+    UniquePtr(UniquePtr&& other) noexcept
+        : Holder(std::move(other.get_deleter())), ptr_(other.release()) {}
 
     // Move assignment operator
     UniquePtr& operator=(UniquePtr&& other) noexcept {
         if (this != &other) {
             reset(other.release());
+            get_deleter() = std::move(other.get_deleter());
         }
         return *this;
     }
@@ -44,7 +101,7 @@ public:
     // Destructor
     ~UniquePtr() {
         if (ptr_) {
-            delete ptr_;
+            get_deleter()(ptr_);
         }
     }
 
@@ -62,6 +119,15 @@ public:
         return ptr_;
     }
 
+    // Access the deleter
+    Deleter& get_deleter() noexcept {
+        return Holder::deleter();
+    }
+
+    const Deleter& get_deleter() const noexcept {
+        return Holder::deleter();
+    }
+
     // Release ownership
     pointer release() noexcept {
         pointer old = ptr_;
@@ -72,8 +138,11 @@ public:
     // Reset pointer
     void reset(pointer ptr = nullptr) noexcept {
         if (ptr_ != ptr) {
-            delete ptr_;
+            pointer old = ptr_;
             ptr_ = ptr;
+            if (old) {
+                get_deleter()(old);
+            }
         }
     }
 
@@ -84,26 +153,34 @@ public:
 };
 
 // Partial specialization for arrays
-template<typename T>
-class UniquePtr<T[]> {
+template<typename T, typename Deleter>
+class UniquePtr<T[], Deleter> : private DeleterHolder<Deleter> {
 private:
     T* ptr_;
 
+    using Holder = DeleterHolder<Deleter>;
+
 public:
     // Type aliases
     using element_type = T;
     using pointer = T*;
+    using deleter_type = Deleter;
 
     // Default constructor (nullptr)
     explicit UniquePtr(pointer ptr = nullptr) noexcept : ptr_(ptr) {}
 
+    // Constructor with a custom deleter instance
+    UniquePtr(pointer ptr, Deleter deleter) noexcept : Holder(std::move(deleter)), ptr_(ptr) {}
+
     // Move constructor
-    UniquePtr(UniquePtr&& other) noexcept : ptr_(other.release()) {}
+    UniquePtr(UniquePtr&& other) noexcept
+        : Holder(std::move(other.get_deleter())), ptr_(other.release()) {}
 
     // Move assignment operator
     UniquePtr& operator=(UniquePtr&& other) noexcept {
         if (this != &other) {
             reset(other.release());
+            get_deleter() = std::move(other.get_deleter());
         }
         return *this;
     }
@@ -112,10 +189,10 @@ public:
     UniquePtr(const UniquePtr&) = delete;
     UniquePtr& operator=(const UniquePtr&) = delete;
 
-    // Destructor - uses delete[] for arrays
+    // Destructor - DefaultDelete<T[]> uses delete[] for arrays
     ~UniquePtr() {
         if (ptr_) {
-            delete[] ptr_;
+            get_deleter()(ptr_);
         }
     }
 
@@ -129,6 +206,15 @@ public:
         return ptr_;
     }
 
+    // Access the deleter
+    Deleter& get_deleter() noexcept {
+        return Holder::deleter();
+    }
+
+    const Deleter& get_deleter() const noexcept {
+        return Holder::deleter();
+    }
+
     // Release ownership
     pointer release() noexcept {
         pointer old = ptr_;
@@ -139,8 +225,11 @@ public:
     // Reset pointer
     void reset(pointer ptr = nullptr) noexcept {
         if (ptr_ != ptr) {
-            delete[] ptr_;
+            pointer old = ptr_;
             ptr_ = ptr;
+            if (old) {
+                get_deleter()(old);
+            }
         }
     }
 
@@ -161,6 +250,379 @@ UniquePtr<T[]> make_unique_array(size_t size) {
     return UniquePtr<T[]>(new T[size]());
 }
 
+// Default-initializing variants (like C++20 std::make_unique_for_overwrite):
+// trivial types are left uninitialized instead of being zeroed, which avoids
+// touching every byte of a buffer that is about to be overwritten anyway
+template<typename T>
+std::enable_if_t<!is_array_type<T>::value, UniquePtr<T>> make_unique_for_overwrite() {
+    return UniquePtr<T>(new T);
+}
+
+template<typename T>
+std::enable_if_t<is_array_type<T>::value && std::extent_v<T> == 0, UniquePtr<T>>
+make_unique_for_overwrite(size_t size) {
+    return UniquePtr<T>(new std::remove_extent_t<T>[size]);
+}
+
+// Deleter for arrays allocated with an explicit alignment (stateless)
+template<typename T, size_t Alignment>
+struct AlignedArrayDelete {
+    void operator()(T* ptr) const noexcept {
+        ::operator delete[](ptr, std::align_val_t(Alignment));
+    }
+};
+
+// Uninitialized array aligned to Alignment bytes (e.g. 64 for SIMD loads,
+// 4096 for O_DIRECT I/O). Limited to trivial element types, since the
+// deleter does not know the element count and runs no destructors.
+template<typename T, size_t Alignment>
+std::enable_if_t<is_array_type<T>::value && std::extent_v<T> == 0,
+                 UniquePtr<T, AlignedArrayDelete<std::remove_extent_t<T>, Alignment>>>
+make_unique_aligned_for_overwrite(size_t size) {
+    using Element = std::remove_extent_t<T>;
+    static_assert(std::is_trivially_default_constructible_v<Element> && std::is_trivially_destructible_v<Element>,
+                  "aligned arrays are limited to trivial element types");
+    static_assert(Alignment >= alignof(Element) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of two no smaller than alignof(T)");
+
+    // new T[size] reports an unrepresentable byte count the same way
+    if (size > SIZE_MAX / sizeof(Element)) {
+        throw std::bad_array_new_length();
+    }
+    void* raw = ::operator new[](size * sizeof(Element), std::align_val_t(Alignment));
+    auto* data = static_cast<Element*>(raw);
+    for (size_t i = 0; i < size; ++i) {
+        new (data + i) Element;  // Default-initialization: no stores for trivial types
+    }
+    return UniquePtr<T, AlignedArrayDelete<Element, Alignment>>(data);
+}
+
+// ============================================================================
+// Fixed-Size Block Pool Allocator
+// ============================================================================
+
+// Hands out blocks of one fixed size from large chunks. Free blocks form an
+// intrusive singly linked list, so allocate/deallocate are a pointer pop/push.
+// Not thread-safe by design: use one pool per thread (see thread_pool()).
+// All blocks must be returned before the pool is destroyed.
+class PoolAllocator {
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    size_t block_size_;
+    size_t blocks_per_chunk_;
+    FreeBlock* free_list_ = nullptr;
+    std::vector<void*> chunks_;
+
+    static size_t round_up(size_t size) {
+        constexpr size_t align = alignof(std::max_align_t);
+        size = size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size;
+        return (size + align - 1) / align * align;
+    }
+
+    void add_chunk() {
+        char* chunk = static_cast<char*>(::operator new(block_size_ * blocks_per_chunk_));
+        chunks_.push_back(chunk);
+        // Thread the new blocks onto the free list
+        for (size_t i = blocks_per_chunk_; i > 0; --i) {
+            auto* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * block_size_);
+            block->next = free_list_;
+            free_list_ = block;
+        }
+    }
+
+public:
+    explicit PoolAllocator(size_t block_size, size_t blocks_per_chunk = 256)
+        : block_size_(round_up(block_size)), blocks_per_chunk_(blocks_per_chunk ? blocks_per_chunk : 1) {}
+
+    ~PoolAllocator() {
+        for (void* chunk : chunks_) {
+            ::operator delete(chunk);
+        }
+    }
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    void* allocate() {
+        if (!free_list_) {
+            add_chunk();
+        }
+        FreeBlock* block = free_list_;
+        free_list_ = block->next;
+        return block;
+    }
+
+    void deallocate(void* ptr) noexcept {
+        auto* block = static_cast<FreeBlock*>(ptr);
+        block->next = free_list_;
+        free_list_ = block;
+    }
+
+    size_t block_size() const noexcept { return block_size_; }
+    size_t chunk_count() const noexcept { return chunks_.size(); }
+
+    // Per-thread pool for blocks of BlockSize bytes
+    template<size_t BlockSize>
+    static PoolAllocator& thread_pool() {
+        static thread_local PoolAllocator pool(BlockSize);
+        return pool;
+    }
+};
+
+// Deleter that destroys the object and returns its block to the pool
+// (holds the pool pointer, so UniquePtr<T, PoolDeleter<T>> is two pointers)
+template<typename T>
+class PoolDeleter {
+private:
+    PoolAllocator* pool_;
+
+public:
+    explicit PoolDeleter(PoolAllocator* pool = nullptr) noexcept : pool_(pool) {}
+
+    void operator()(T* ptr) const noexcept {
+        ptr->~T();
+        pool_->deallocate(ptr);
+    }
+};
+
+// Create a pool-allocated UniquePtr (allocation is a free-list pop)
+template<typename T, typename... Args>
+UniquePtr<T, PoolDeleter<T>> allocate_unique(PoolAllocator& pool, Args&&... args) {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned types are not supported by PoolAllocator");
+    if (sizeof(T) > pool.block_size()) {
+        throw std::invalid_argument("allocate_unique: type does not fit in pool block");
+    }
+
+    void* block = pool.allocate();
+    try {
+        T* obj = new (block) T(std::forward<Args>(args)...);
+        return UniquePtr<T, PoolDeleter<T>>(obj, PoolDeleter<T>(&pool));
+    } catch (...) {
+        pool.deallocate(block);
+        throw;
+    }
+}
+
+// ============================================================================
+// Intrusive Reference-Counted Pointer
+// ============================================================================
+
+// Reference count policy: atomic for objects shared across threads, plain
+// integer for thread-confined objects (no lock-prefixed instructions)
+template<bool ThreadSafe>
+class RefCount;
+
+template<>
+class RefCount<true> {
+private:
+    std::atomic<size_t> count_{0};
+
+public:
+    void increment() noexcept {
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Returns true when the last reference is dropped
+    bool decrement() noexcept {
+        if (count_.fetch_sub(1, std::memory_order_release) == 1) {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return true;
+        }
+        return false;
+    }
+
+    size_t get() const noexcept {
+        return count_.load(std::memory_order_relaxed);
+    }
+};
+
+template<>
+class RefCount<false> {
+private:
+    size_t count_ = 0;
+
+public:
+    void increment() noexcept {
+        ++count_;
+    }
+
+    bool decrement() noexcept {
+        return --count_ == 0;
+    }
+
+    size_t get() const noexcept {
+        return count_;
+    }
+};
+
+// CRTP base that embeds the count in the object itself, so a shared object
+// is one allocation with no separate control block. The last release deletes
+// through Derived*, which needs no virtual destructor only while Derived is
+// the type that was allocated. An object of a class derived from Derived is
+// destroyed correctly only if Derived's destructor is virtual, so
+// IntrusivePtr refuses to adopt any other type unless it is.
+template<typename Derived, bool ThreadSafe = true>
+class RefCounted {
+private:
+    mutable RefCount<ThreadSafe> ref_count_;
+
+protected:
+    RefCounted() = default;
+    ~RefCounted() = default;
+
+public:
+    // The type release() deletes through
+    using refcounted_type = Derived;
+
+    // Copying an object does not copy its references
+    RefCounted(const RefCounted&) noexcept {}
+    RefCounted& operator=(const RefCounted&) noexcept { return *this; }
+
+    void add_ref() const noexcept {
+        ref_count_.increment();
+    }
+
+    void release() const noexcept {
+        if (ref_count_.decrement()) {
+            delete static_cast<const Derived*>(this);
+        }
+    }
+
+    size_t use_count() const noexcept {
+        return ref_count_.get();
+    }
+};
+
+template<typename T>
+class IntrusivePtr {
+private:
+    T* ptr_;
+
+    template<typename U>
+    friend class IntrusivePtr;
+
+    // Whether a U allocated with new may be adopted: the last release
+    // deletes through U's RefCounted Derived, which is undefined behaviour
+    // for a U that is anything else unless that type's destructor is virtual
+    template<typename U>
+    static constexpr bool deletes_safely_v =
+        std::is_same_v<std::remove_cv_t<U>, typename std::remove_cv_t<U>::refcounted_type> ||
+        std::has_virtual_destructor_v<typename std::remove_cv_t<U>::refcounted_type>;
+
+public:
+    // Type aliases
+    using element_type = T;
+    using pointer = T*;
+
+    // Default constructor (nullptr)
+    IntrusivePtr() noexcept : ptr_(nullptr) {}
+
+    // Take a new reference to an object. Objects enter an IntrusivePtr only
+    // through these constructors and UniquePtr adoption, so the deletion
+    // check is made here; converting between IntrusivePtrs needs none. The
+    // check sees the static type only: a Derived* that really points at a
+    // subclass still needs Derived's destructor to be virtual.
+    explicit IntrusivePtr(pointer ptr) noexcept : ptr_(ptr) {
+        static_assert(deletes_safely_v<T>, "IntrusivePtr<T>: T is not its RefCounted type, which needs a virtual destructor");
+        if (ptr_) {
+            ptr_->add_ref();
+        }
+    }
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*> && !std::is_same_v<U, T>>>
+    explicit IntrusivePtr(U* ptr) noexcept : ptr_(ptr) {
+        static_assert(deletes_safely_v<U>, "IntrusivePtr from U*: U is not its RefCounted type, which needs a virtual destructor");
+        if (ptr_) {
+            ptr_->add_ref();
+        }
+    }
+
+    // Adopt an exclusively owned object: the object is not reallocated or
+    // copied, only its embedded count goes from 0 to 1
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    IntrusivePtr(UniquePtr<U>&& owner) noexcept : IntrusivePtr(owner.release()) {}
+
+    // Copy constructor (shares ownership)
+    IntrusivePtr(const IntrusivePtr& other) noexcept : IntrusivePtr(other.ptr_) {}
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    IntrusivePtr(const IntrusivePtr<U>& other) noexcept : IntrusivePtr(other.ptr_) {}
+
+    // Move constructor (no count traffic)
+    IntrusivePtr(IntrusivePtr&& other) noexcept : ptr_(other.ptr_) {
+        other.ptr_ = nullptr;
+    }
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    IntrusivePtr(IntrusivePtr<U>&& other) noexcept : ptr_(other.ptr_) {
+        other.ptr_ = nullptr;
+    }
+
+    // Copy and move assignment (copy-and-swap handles self-assignment)
+    IntrusivePtr& operator=(const IntrusivePtr& other) noexcept {
+        IntrusivePtr(other).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    // Destructor
+    ~IntrusivePtr() {
+        if (ptr_) {
+            ptr_->release();
+        }
+    }
+
+    T& operator*() const noexcept {
+        return *ptr_;
+    }
+
+    pointer operator->() const noexcept {
+        return ptr_;
+    }
+
+    pointer get() const noexcept {
+        return ptr_;
+    }
+
+    size_t use_count() const noexcept {
+        return ptr_ ? ptr_->use_count() : 0;
+    }
+
+    void reset(pointer ptr = nullptr) noexcept {
+        IntrusivePtr(ptr).swap(*this);
+    }
+
+    template<typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*> && !std::is_same_v<U, T>>>
+    void reset(U* ptr) noexcept {
+        IntrusivePtr(ptr).swap(*this);
+    }
+
+    void swap(IntrusivePtr& other) noexcept {
+        std::swap(ptr_, other.ptr_);
+    }
+
+    explicit operator bool() const noexcept {
+        return ptr_ != nullptr;
+    }
+};
+
+// Helper function to create IntrusivePtr (one allocation: object and count)
+template<typename T, typename... Args>
+IntrusivePtr<T> make_intrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+// Other files include this one for its smart pointers; they define
+// EXERCISE_1_NO_MAIN to leave out the tests and main()
+#ifndef EXERCISE_1_NO_MAIN
+
 // Test class with destructor to verify cleanup
 class TestResource {
 private:
@@ -170,12 +632,12 @@ private:
 public:
     explicit TestResource(int v) : value_(v) {
         ++count_;
-        std::cout << "TestResource(" << value_ << ") created. Count: " << count_ << std::endl;
+        TRACE_INFO("TestResource(", value_, ") created. Count: ", count_);
     }
 
     ~TestResource() {
         --count_;
-        std::cout << "TestResource(" << value_ << ") destroyed. Count: " << count_ << std::endl;
+        TRACE_INFO("TestResource(", value_, ") destroyed. Count: ", count_);
     }
 
     int getValue() const { return value_; }
@@ -273,7 +735,190 @@ int main() {
     }
     std::cout << std::endl;
 
+    // Test 9: Custom deleters and empty base optimization
+    std::cout << "Test 9: Custom deleters (EBO)\n";
+    {
+        struct CountingDelete {
+            int* deletions;
+            void operator()(int* p) const noexcept {
+                ++*deletions;
+                delete p;
+            }
+        };
+
+        std::cout << "sizeof(int*): " << sizeof(int*) << std::endl;
+        std::cout << "sizeof(UniquePtr<int>): " << sizeof(UniquePtr<int>) << std::endl;
+        std::cout << "sizeof(UniquePtr<int[]>): " << sizeof(UniquePtr<int[]>) << std::endl;
+        std::cout << "sizeof(UniquePtr<int, CountingDelete>): " << sizeof(UniquePtr<int, CountingDelete>)
+                  << " (stateful deleter is stored)" << std::endl;
+        static_assert(sizeof(UniquePtr<int>) == sizeof(int*), "empty deleter must not add storage");
+        static_assert(sizeof(UniquePtr<int[]>) == sizeof(int*), "empty deleter must not add storage");
+
+        int deletions = 0;
+        {
+            UniquePtr<int, CountingDelete> p1(new int(1), CountingDelete{&deletions});
+            UniquePtr<int, CountingDelete> p2 = std::move(p1);
+            p2.reset(new int(2));
+        }
+        std::cout << "Custom deleter calls: " << deletions << " (expected 2)" << std::endl;
+    }
+    std::cout << std::endl;
+
+    // Test 10: Pool allocator with allocate_unique
+    std::cout << "Test 10: Pool allocator with allocate_unique\n";
+    {
+        std::cout << "Initial count: " << TestResource::getCount() << std::endl;
+        PoolAllocator pool(sizeof(TestResource), 4);
+        {
+            auto r1 = allocate_unique<TestResource>(pool, 1000);
+            auto r2 = allocate_unique<TestResource>(pool, 2000);
+            std::cout << "Values: " << r1->getValue() << ", " << r2->getValue() << std::endl;
+            std::cout << "sizeof(UniquePtr<TestResource, PoolDeleter>): "
+                      << sizeof(UniquePtr<TestResource, PoolDeleter<TestResource>>) << std::endl;
+        }
+        std::cout << "Count after destruction: " << TestResource::getCount() << std::endl;
+
+        // Freed blocks are reused, so churn never grows the pool
+        struct Small {
+            int a;
+            int b;
+        };
+        PoolAllocator& small_pool = PoolAllocator::thread_pool<sizeof(Small)>();
+        const int iterations = 1000000;
+        for (int i = 0; i < iterations; ++i) {
+            auto p = allocate_unique<Small>(small_pool, Small{i, i});
+        }
+        std::cout << "Thread pool chunks after " << iterations << " allocations: " << small_pool.chunk_count() << std::endl;
+
+        // A throwing constructor returns the block to the pool
+        struct Throwing {
+            Throwing() { throw std::runtime_error("constructor failed"); }
+        };
+        PoolAllocator throwing_pool(sizeof(Throwing), 1);
+        for (int i = 0; i < 3; ++i) {
+            try {
+                auto p = allocate_unique<Throwing>(throwing_pool);
+            } catch (const std::exception& e) {
+                std::cout << "Caught: " << e.what() << std::endl;
+            }
+        }
+        std::cout << "Chunks after failed constructions: " << throwing_pool.chunk_count() << " (expected 1)" << std::endl;
+    }
+    std::cout << std::endl;
+
+    // Test 11: Default-initialized (for overwrite) allocations
+    std::cout << "Test 11: make_unique_for_overwrite\n";
+    {
+        const size_t size = 4 * 1024 * 1024;
+
+        // Buffer is left uninitialized, then fully overwritten (e.g. by a read)
+        auto buffer = make_unique_for_overwrite<unsigned char[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i] = static_cast<unsigned char>(i);
+        }
+        std::cout << "Buffer[255]: " << static_cast<int>(buffer[255]) << std::endl;
+
+        auto single = make_unique_for_overwrite<int>();
+        *single = 7;
+        std::cout << "Single value: " << *single << std::endl;
+
+        auto simd = make_unique_aligned_for_overwrite<float[], 64>(1024);
+        auto page = make_unique_aligned_for_overwrite<char[], 4096>(size);
+        std::cout << "64-byte aligned: " << (reinterpret_cast<std::uintptr_t>(simd.get()) % 64 == 0 ? "yes" : "no") << std::endl;
+        std::cout << "4096-byte aligned: " << (reinterpret_cast<std::uintptr_t>(page.get()) % 4096 == 0 ? "yes" : "no") << std::endl;
+        std::cout << "sizeof(aligned UniquePtr): " << sizeof(simd) << std::endl;
+        try {
+            make_unique_aligned_for_overwrite<float[], 64>(SIZE_MAX / 2);
+            std::cout << "Overflowing size: allocated (wrong)" << std::endl;
+        } catch (const std::bad_array_new_length&) {
+            std::cout << "Overflowing size: std::bad_array_new_length" << std::endl;
+        }
+    }
+    std::cout << std::endl;
+
+    // Test 12: Intrusive reference counting
+    std::cout << "Test 12: IntrusivePtr\n";
+    {
+        class SharedResource : public RefCounted<SharedResource> {
+        private:
+            int value_;
+
+        public:
+            explicit SharedResource(int v) : value_(v) {
+                std::cout << "SharedResource(" << value_ << ") created" << std::endl;
+            }
+            ~SharedResource() {
+                std::cout << "SharedResource(" << value_ << ") destroyed" << std::endl;
+            }
+            int getValue() const { return value_; }
+        };
+
+        class LocalResource : public RefCounted<LocalResource, false> {
+        public:
+            int hits = 0;
+        };
+
+        std::cout << "sizeof(IntrusivePtr<SharedResource>): " << sizeof(IntrusivePtr<SharedResource>) << std::endl;
+
+        auto p1 = make_intrusive<SharedResource>(700);
+        {
+            IntrusivePtr<SharedResource> p2 = p1;
+            IntrusivePtr<SharedResource> p3;
+            p3 = p2;
+            std::cout << "use_count with three owners: " << p1.use_count() << std::endl;
+        }
+        std::cout << "use_count after inner scope: " << p1.use_count() << std::endl;
+
+        // Atomic count survives copies from many threads
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads.emplace_back([p1]() {
+                for (int j = 0; j < 10000; ++j) {
+                    IntrusivePtr<SharedResource> copy = p1;
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        std::cout << "use_count after threaded copies: " << p1.use_count() << std::endl;
+
+        // Conversion from UniquePtr keeps the same object
+        UniquePtr<SharedResource> unique(new SharedResource(800));
+        SharedResource* address = unique.get();
+        IntrusivePtr<SharedResource> shared = std::move(unique);
+        std::cout << "Converted from UniquePtr without reallocation: " << (shared.get() == address ? "yes" : "no")
+                  << ", unique valid: " << (unique ? "yes" : "no") << ", use_count: " << shared.use_count() << std::endl;
+
+        // Thread-confined object with a plain integer count
+        auto local = make_intrusive<LocalResource>();
+        IntrusivePtr<LocalResource> local_copy = local;
+        local_copy->hits++;
+        std::cout << "Non-atomic use_count: " << local.use_count() << ", hits: " << local->hits << std::endl;
+
+        // Sharing through a base: allowed only because Shape's destructor is
+        // virtual, so the last release runs ~Circle. Without it,
+        //   struct A : RefCounted<A> {}; struct B : A { std::string s; };
+        //   make_intrusive<B>();  // or IntrusivePtr<B>(new B), IntrusivePtr<A>(new B)
+        // fails to compile: release() would delete a B through an A*
+        class Shape : public RefCounted<Shape> {
+        public:
+            virtual ~Shape() = default;
+        };
+        class Circle : public Shape {
+        public:
+            ~Circle() override {
+                std::cout << "Circle destroyed through IntrusivePtr<Shape>" << std::endl;
+            }
+        };
+        IntrusivePtr<Shape> shape = make_intrusive<Circle>();
+        IntrusivePtr<Shape> shape_copy = shape;
+        std::cout << "Shape use_count: " << shape.use_count() << std::endl;
+    }
+    std::cout << std::endl;
+
     std::cout << "All tests completed!\n";
     return 0;
 }
 
+#endif  // EXERCISE_1_NO_MAIN
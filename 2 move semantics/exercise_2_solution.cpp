@@ -4,6 +4,14 @@
 #include <type_traits>
 #include <string>
 #include <vector>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstring>
+
+#include "../common/tracing.h"
+#include "../common/tracking.h"  // Counters for the hot-path checks in Test 8
 
 // ============================================================================
 // 1. Generic Factory Function with Perfect Forwarding
@@ -31,20 +39,20 @@ public:
     template<typename U>
     explicit Wrapper(U&& val) 
         : value_(std::forward<U>(val)) {
-        std::cout << "Wrapper constructed (forwarding)" << std::endl;
+        TRACE_INFO("Wrapper constructed (forwarding)");
     }
 
     // Move constructor
     Wrapper(Wrapper&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
         : value_(std::move(other.value_)) {
-        std::cout << "Wrapper move constructed" << std::endl;
+        TRACE_DEBUG("Wrapper move constructed");
     }
 
     // Move assignment operator
     Wrapper& operator=(Wrapper&& other) noexcept(std::is_nothrow_move_assignable_v<T>) {
         if (this != &other) {
             value_ = std::move(other.value_);
-            std::cout << "Wrapper move assigned" << std::endl;
+            TRACE_DEBUG("Wrapper move assigned");
         }
         return *this;
     }
@@ -93,41 +101,176 @@ conditional_move(T&& val) {
 // 4. Resource Manager with Move Semantics
 // ============================================================================
 
+// Size-class cache of raw buffers. Blocks are rounded up to a power of two
+// and kept on a per-class free list when released, so steady-state buffer
+// churn is served from the cache instead of the system allocator. Blocks
+// larger than the biggest class go straight to malloc/free.
+// Not thread-safe: use one pool per thread (e.g. per request handler).
+class BufferPool {
+public:
+    static constexpr size_t min_class_bytes = 64;
+    static constexpr size_t num_classes = 20;  // 64 B .. 32 MiB
+
+private:
+    std::vector<void*> free_lists_[num_classes];
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+
+    static size_t class_index(size_t bytes) {
+        size_t index = 0;
+        size_t class_bytes = min_class_bytes;
+        while (class_bytes < bytes && index < num_classes) {
+            class_bytes <<= 1;
+            ++index;
+        }
+        return index;
+    }
+
+public:
+    BufferPool() = default;
+
+    ~BufferPool() {
+        for (auto& list : free_lists_) {
+            for (void* block : list) {
+                std::free(block);
+            }
+        }
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Usable size of a block acquired for the given request
+    static size_t block_size(size_t bytes) {
+        size_t index = class_index(bytes);
+        return index < num_classes ? min_class_bytes << index : bytes;
+    }
+
+    void* acquire(size_t bytes) {
+        size_t index = class_index(bytes);
+        if (index < num_classes && !free_lists_[index].empty()) {
+            void* block = free_lists_[index].back();
+            free_lists_[index].pop_back();
+            ++hits_;
+            return block;
+        }
+
+        ++misses_;
+        void* block = std::malloc(block_size(bytes));
+        if (!block) {
+            throw std::bad_alloc();
+        }
+        return block;
+    }
+
+    // bytes must be the block_size() the block was acquired with
+    void release(void* block, size_t bytes) noexcept {
+        size_t index = class_index(bytes);
+        if (index >= num_classes) {
+            std::free(block);
+            return;
+        }
+        try {
+            free_lists_[index].push_back(block);
+        } catch (...) {
+            std::free(block);
+        }
+    }
+
+    size_t hits() const { return hits_; }
+    size_t misses() const { return misses_; }
+};
+
+// Growable int buffer. int is trivially relocatable, so growing never moves
+// elements one by one: unpooled buffers use realloc (which can extend in
+// place, and glibc serves large blocks with mremap), pooled buffers use one
+// memcpy into the next size class.
 class ResourceManager {
 private:
     size_t size_;
+    size_t capacity_ = 0;
     int* buffer_;  // Simulated resource (could be file handle, socket, etc.)
+    BufferPool* pool_ = nullptr;
+
+    void release_buffer() noexcept {
+        if (!buffer_) {
+            return;
+        }
+        if (pool_) {
+            pool_->release(buffer_, capacity_ * sizeof(int));
+        } else {
+            std::free(buffer_);
+        }
+    }
+
+    // Strong guarantee: on failure the current buffer is left untouched
+    void reallocate(size_t new_capacity) {
+        new_capacity = new_capacity ? new_capacity : 1;
+
+        if (pool_) {
+            size_t bytes = BufferPool::block_size(new_capacity * sizeof(int));
+            int* block = static_cast<int*>(pool_->acquire(bytes));
+            if (buffer_) {
+                std::memcpy(block, buffer_, size_ * sizeof(int));
+            }
+            release_buffer();
+            buffer_ = block;
+            capacity_ = bytes / sizeof(int);
+        } else {
+            void* block = std::realloc(buffer_, new_capacity * sizeof(int));
+            if (!block) {
+                throw std::bad_alloc();
+            }
+            buffer_ = static_cast<int*>(block);
+            capacity_ = new_capacity;
+        }
+    }
 
 public:
-    // Constructor
+    // Constructor (calloc hands back already-zeroed pages for large sizes)
     explicit ResourceManager(size_t size) 
-        : size_(size), buffer_(new int[size]()) {
-        std::cout << "ResourceManager: Allocated " << size_ << " elements" << std::endl;
+        : size_(size), capacity_(size), buffer_(static_cast<int*>(std::calloc(size ? size : 1, sizeof(int)))) {
+        if (!buffer_) {
+            throw std::bad_alloc();
+        }
+        TRACE_INFO("ResourceManager: Allocated ", size_, " elements");
+    }
+
+    // Constructor drawing its buffer from a pool
+    ResourceManager(size_t size, BufferPool& pool)
+        : size_(size), buffer_(nullptr), pool_(&pool) {
+        reallocate(size);
+        std::memset(buffer_, 0, size_ * sizeof(int));
+        TRACE_INFO("ResourceManager: Allocated ", size_, " elements (pooled)");
     }
 
     // Move constructor
     ResourceManager(ResourceManager&& other) noexcept
-        : size_(other.size_), buffer_(other.buffer_) {
+        : size_(other.size_), capacity_(other.capacity_), buffer_(other.buffer_), pool_(other.pool_) {
         other.size_ = 0;
+        other.capacity_ = 0;
         other.buffer_ = nullptr;
-        std::cout << "ResourceManager: Move constructed" << std::endl;
+        TRACE_DEBUG("ResourceManager: Move constructed");
     }
 
     // Move assignment operator
     ResourceManager& operator=(ResourceManager&& other) noexcept {
         if (this != &other) {
-            // Clean up existing resource
-            delete[] buffer_;
+            // Clean up existing resource (back to the pool if it came from one)
+            release_buffer();
             
             // Transfer ownership
             size_ = other.size_;
+            capacity_ = other.capacity_;
             buffer_ = other.buffer_;
+            pool_ = other.pool_;
             
             // Reset source
             other.size_ = 0;
+            other.capacity_ = 0;
             other.buffer_ = nullptr;
             
-            std::cout << "ResourceManager: Move assigned" << std::endl;
+            TRACE_DEBUG("ResourceManager: Move assigned");
         }
         return *this;
     }
@@ -139,13 +282,44 @@ public:
     // Destructor
     ~ResourceManager() {
         if (buffer_) {
-            delete[] buffer_;
-            std::cout << "ResourceManager: Released " << size_ << " elements" << std::endl;
+            release_buffer();
+            TRACE_INFO("ResourceManager: Released ", size_, " elements");
+        }
+    }
+
+    // Ensure room for at least new_capacity elements without changing size()
+    void reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            reallocate(new_capacity);
+        }
+    }
+
+    // Change size(); grows capacity geometrically and zero-fills new elements
+    void resize(size_t new_size) {
+        if (new_size > capacity_) {
+            size_t grown = capacity_ * 2;
+            reallocate(grown > new_size ? grown : new_size);
+        }
+        if (new_size > size_) {
+            std::memset(buffer_ + size_, 0, (new_size - size_) * sizeof(int));
+        }
+        size_ = new_size;
+    }
+
+    // Drop unused capacity (pooled buffers shrink to the smallest fitting class)
+    void shrink_to_fit() {
+        size_t target = size_ ? size_ : 1;
+        if (pool_) {
+            target = BufferPool::block_size(target * sizeof(int)) / sizeof(int);
+        }
+        if (buffer_ && target < capacity_) {
+            reallocate(target);
         }
     }
 
     // Accessors
     size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
     bool valid() const { return buffer_ != nullptr; }
     int& operator[](size_t index) { return buffer_[index]; }
     const int& operator[](size_t index) const { return buffer_[index]; }
@@ -240,6 +414,167 @@ public:
     }
 };
 
+// ============================================================================
+// 6. Small-Buffer-Optimized Type-Erased Box
+// ============================================================================
+
+// Move-only owner of one object of any type. Objects that fit in Capacity
+// bytes (and are nothrow-movable, so moving the box stays noexcept) live
+// inside the box; larger ones fall back to the heap. Each stored type gets
+// one static table of operations, which doubles as its type identity.
+template<size_t Capacity, size_t Alignment = alignof(std::max_align_t)>
+class InlineBox {
+    static_assert(Capacity >= sizeof(void*), "InlineBox must be able to hold a heap pointer");
+
+private:
+    struct Ops {
+        void (*destroy)(InlineBox& box) noexcept;
+        void (*move)(InlineBox& from, InlineBox& to) noexcept;
+        bool is_inline;
+    };
+
+    std::aligned_storage_t<Capacity, Alignment> storage_;
+    const Ops* ops_ = nullptr;
+
+    template<typename T>
+    static constexpr bool fits_inline = sizeof(T) <= Capacity &&
+                                        Alignment % alignof(T) == 0 &&
+                                        std::is_nothrow_move_constructible_v<T>;
+
+    template<typename T>
+    T* inline_ptr() {
+        return reinterpret_cast<T*>(&storage_);
+    }
+
+    template<typename T>
+    T*& heap_ptr() {
+        return *reinterpret_cast<T**>(&storage_);
+    }
+
+    template<typename T>
+    static void destroy_inline(InlineBox& box) noexcept {
+        box.inline_ptr<T>()->~T();
+    }
+
+    template<typename T>
+    static void move_inline(InlineBox& from, InlineBox& to) noexcept {
+        new (&to.storage_) T(std::move(*from.inline_ptr<T>()));
+        from.inline_ptr<T>()->~T();
+    }
+
+    template<typename T>
+    static void destroy_heap(InlineBox& box) noexcept {
+        delete box.heap_ptr<T>();
+    }
+
+    template<typename T>
+    static void move_heap(InlineBox& from, InlineBox& to) noexcept {
+        new (&to.storage_) T*(from.heap_ptr<T>());
+    }
+
+    template<typename T>
+    static constexpr Ops make_ops() {
+        if constexpr (fits_inline<T>) {
+            return Ops{&destroy_inline<T>, &move_inline<T>, true};
+        } else {
+            return Ops{&destroy_heap<T>, &move_heap<T>, false};
+        }
+    }
+
+    template<typename T>
+    static inline constexpr Ops ops_for = make_ops<T>();
+
+    void move_from(InlineBox& other) noexcept {
+        if (other.ops_) {
+            other.ops_->move(other, *this);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+public:
+    InlineBox() noexcept = default;
+
+    // Construct the payload in place
+    template<typename T, typename... Args>
+    explicit InlineBox(std::in_place_type_t<T>, Args&&... args) {
+        if constexpr (fits_inline<T>) {
+            new (&storage_) T(std::forward<Args>(args)...);
+        } else {
+            new (&storage_) T*(new T(std::forward<Args>(args)...));
+        }
+        ops_ = &ops_for<T>;
+    }
+
+    // Move constructor
+    InlineBox(InlineBox&& other) noexcept {
+        move_from(other);
+    }
+
+    // Move assignment operator
+    InlineBox& operator=(InlineBox&& other) noexcept {
+        if (this != &other) {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+
+    // Delete copy operations
+    InlineBox(const InlineBox&) = delete;
+    InlineBox& operator=(const InlineBox&) = delete;
+
+    ~InlineBox() {
+        reset();
+    }
+
+    void reset() noexcept {
+        if (ops_) {
+            ops_->destroy(*this);
+            ops_ = nullptr;
+        }
+    }
+
+    bool has_value() const noexcept { return ops_ != nullptr; }
+    bool is_inline() const noexcept { return ops_ && ops_->is_inline; }
+
+    template<typename T>
+    bool holds() const noexcept {
+        return ops_ == &ops_for<T>;
+    }
+
+    // Access the payload (nullptr if the box holds another type or nothing)
+    template<typename T>
+    T* get_if() noexcept {
+        if (!holds<T>()) {
+            return nullptr;
+        }
+        if constexpr (fits_inline<T>) {
+            return inline_ptr<T>();
+        } else {
+            return heap_ptr<T>();
+        }
+    }
+
+    template<typename T>
+    T& get() {
+        T* ptr = get_if<T>();
+        if (!ptr) {
+            throw std::runtime_error("InlineBox: bad type access");
+        }
+        return *ptr;
+    }
+};
+
+// Sized to keep common small payloads (a std::string, a few scalars) inline
+using SmallResource = InlineBox<48>;
+
+// Counterpart of make_resource that avoids the heap for small types
+template<typename T, typename... Args>
+SmallResource make_small_resource(Args&&... args) {
+    return SmallResource(std::in_place_type<T>, std::forward<Args>(args)...);
+}
+
 // ============================================================================
 // Test Classes
 // ============================================================================
@@ -252,24 +587,24 @@ private:
 
 public:
     explicit TestClass(const std::string& name) : name_(name) {
-        std::cout << "  TestClass(" << name_ << ") constructed" << std::endl;
+        TRACE_INFO("  TestClass(", name_, ") constructed");
     }
 
     TestClass(const TestClass& other) : name_(other.name_) {
         ++copy_count_;
-        std::cout << "  TestClass(" << name_ << ") copied (total copies: " << copy_count_ << ")" << std::endl;
+        TRACE_DEBUG("  TestClass(", name_, ") copied (total copies: ", copy_count_, ")");
     }
 
     TestClass(TestClass&& other) noexcept : name_(std::move(other.name_)) {
         ++move_count_;
-        std::cout << "  TestClass(" << name_ << ") moved (total moves: " << move_count_ << ")" << std::endl;
+        TRACE_DEBUG("  TestClass(", name_, ") moved (total moves: ", move_count_, ")");
     }
 
     TestClass& operator=(const TestClass& other) {
         if (this != &other) {
             name_ = other.name_;
             ++copy_count_;
-            std::cout << "  TestClass(" << name_ << ") copy assigned" << std::endl;
+            TRACE_DEBUG("  TestClass(", name_, ") copy assigned");
         }
         return *this;
     }
@@ -278,7 +613,7 @@ public:
         if (this != &other) {
             name_ = std::move(other.name_);
             ++move_count_;
-            std::cout << "  TestClass(" << name_ << ") move assigned" << std::endl;
+            TRACE_DEBUG("  TestClass(", name_, ") move assigned");
         }
         return *this;
     }
@@ -389,7 +724,139 @@ int main() {
     }
     std::cout << std::endl;
 
+    // Test 6: Small-buffer-optimized box
+    std::cout << "Test 6: Small-Buffer-Optimized InlineBox\n";
+    {
+        TestClass::resetCounters();
+
+        struct Large {
+            char payload[256];
+        };
+
+        std::cout << "sizeof(SmallResource): " << sizeof(SmallResource) << std::endl;
+
+        auto small = make_small_resource<TestClass>(std::string("InlineObject"));
+        auto large = make_small_resource<Large>();
+        std::cout << "TestClass stored inline: " << (small.is_inline() ? "yes" : "no") << std::endl;
+        std::cout << "Large stored inline: " << (large.is_inline() ? "yes" : "no") << std::endl;
+
+        std::cout << "Moving inline box (moves the payload):\n";
+        SmallResource moved = std::move(small);
+        std::cout << "Name: " << moved.get<TestClass>().getName() << std::endl;
+
+        std::cout << "Moving heap box (moves only the pointer):\n";
+        SmallResource moved_large = std::move(large);
+        std::cout << "Source boxes empty: " << (!small.has_value() && !large.has_value() ? "yes" : "no") << std::endl;
+
+        std::cout << "Holds TestClass: " << (moved.holds<TestClass>() ? "yes" : "no")
+                  << ", holds Large: " << (moved.holds<Large>() ? "yes" : "no") << std::endl;
+        try {
+            moved.get<Large>();
+        } catch (const std::exception& e) {
+            std::cout << "Caught: " << e.what() << std::endl;
+        }
+
+        TestClass::printCounters();
+    }
+    std::cout << std::endl;
+
+    // Test 7: Growable and pooled resource manager
+    std::cout << "Test 7: Growable and Pooled ResourceManager\n";
+    {
+        ResourceManager rm(4);
+        for (size_t i = 0; i < rm.size(); ++i) {
+            rm[i] = static_cast<int>(i);
+        }
+
+        std::cout << "Capacity while growing one element at a time:";
+        size_t last_capacity = rm.capacity();
+        for (size_t n = 5; n <= 100; ++n) {
+            rm.resize(n);
+            rm[n - 1] = static_cast<int>(n - 1);
+            if (rm.capacity() != last_capacity) {
+                last_capacity = rm.capacity();
+                std::cout << " " << last_capacity;
+            }
+        }
+        std::cout << std::endl;
+
+        bool intact = true;
+        for (size_t i = 0; i < rm.size(); ++i) {
+            intact = intact && rm[i] == static_cast<int>(i);
+        }
+        std::cout << "Contents preserved across growth: " << (intact ? "yes" : "no") << std::endl;
+
+        rm.resize(10);
+        rm.shrink_to_fit();
+        std::cout << "After resize(10) + shrink_to_fit: size " << rm.size() << ", capacity " << rm.capacity() << std::endl;
+
+        rm.reserve(1000);
+        std::cout << "After reserve(1000): size " << rm.size() << ", capacity " << rm.capacity()
+                  << ", rm[9] = " << rm[9] << std::endl;
+
+        BufferPool pool;
+        for (int request = 0; request < 5; ++request) {
+            ResourceManager scratch(1000, pool);
+            scratch.resize(3000);
+            ResourceManager other(500, pool);
+            other = std::move(scratch);  // other's old block goes back to the pool
+        }
+        std::cout << "Pool hits: " << pool.hits() << ", misses: " << pool.misses() << std::endl;
+    }
+    std::cout << std::endl;
+
+    // Test 8: Hot paths verified copy-free and allocation-free (the exit
+    // code reports a regression to CTest)
+    std::cout << "Test 8: Zero-Copy / Zero-Allocation Hot Paths\n";
+    bool clean = true;
+    {
+        using Name = tracking::Tracked<std::string>;
+        auto report = [&clean](const char* path, const tracking::Counts& counts, bool hot) {
+            std::cout << path << ": " << counts.copies() << " copies, " << counts.moves() << " moves, "
+                      << counts.allocations() << " allocations" << std::endl;
+            if (hot) {
+                clean = clean && counts.copies() == 0 && counts.allocations() == 0;
+            }
+        };
+
+        std::vector<Name> names;
+        names.reserve(4);
+        {
+            tracking::Scope scope(TRACKING_SITE("vector push_back(rvalue)"));
+            for (int i = 0; i < 4; ++i) {
+                names.push_back(Name(std::string("element")));
+            }
+            report("vector push_back(rvalue) into reserved storage", scope.counts(), true);
+        }
+        Name long_name(std::string(64, 'x'));
+        {
+            tracking::Scope scope(TRACKING_SITE("Wrapper forward + move"));
+            Wrapper<Name> wrapped(std::move(long_name));
+            Wrapper<Name> moved = std::move(wrapped);
+            report("Wrapper forward + move", scope.counts(), true);
+        }
+        {
+            tracking::Scope scope(TRACKING_SITE("InlineBox inline move"));
+            auto box = make_small_resource<Name>(std::string("inline"));
+            SmallResource moved = std::move(box);
+            report("InlineBox inline move", scope.counts(), true);
+        }
+        {
+            ResourceManager rm(8);
+            tracking::Scope scope(TRACKING_SITE("ResourceManager move"));
+            ResourceManager moved = std::move(rm);
+            report("ResourceManager move", scope.counts(), true);
+        }
+        {
+            tracking::Scope scope(TRACKING_SITE("vector copy (pessimized)"));
+            std::vector<Name> copy = names;
+            report("Copying the vector (expected to be caught)", scope.counts(), false);
+        }
+        std::cout << "Hot paths copy-free and allocation-free: " << (clean ? "yes" : "no") << std::endl;
+    }
+    std::cout << std::endl;
+
     std::cout << "All tests completed!\n";
-    return 0;
+    return clean ? 0 : 1;
 }
 
@@ -7,111 +7,1570 @@
 #include <optional>
 #include <chrono>
 #include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <iterator>
+#include <string>
+#include <stdexcept>
+#include <functional>
+#include <future>
+#include <memory>
+#include <exception>
+#include <cstdint>
+#include <tuple>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <ostream>
+#include <sstream>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "../common/sharded_counter.h"
+#include "../common/tracking.h"
 
 // ============================================================================
-// Thread-Safe Queue Implementation
+// Queue Instrumentation (Stats Policies for ThreadSafeQueue)
+// ============================================================================
+
+// Log-linear latency histogram in the style of HdrHistogram. Values below
+// sub_buckets nanoseconds get a bucket each; every power of two above that
+// is split into sub_buckets equal buckets, so a value is reported to within
+// 1/sub_buckets (about 3%) of what was recorded, from nanoseconds up to the
+// full 64-bit range, in a fixed 1920 counters.
+class LatencyHistogram {
+public:
+    static constexpr unsigned sub_bucket_bits = 5;
+    static constexpr size_t sub_buckets = size_t{1} << sub_bucket_bits;
+    static constexpr size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+    static size_t index_of(uint64_t value) {
+        if (value < sub_buckets) {
+            return static_cast<size_t>(value);
+        }
+        unsigned shift = highest_bit(value) - sub_bucket_bits;
+        return (shift + 1) * sub_buckets + static_cast<size_t>((value >> shift) - sub_buckets);
+    }
+
+    // Largest value that lands in bucket `index`
+    static uint64_t highest_equivalent(size_t index) {
+        size_t group = index / sub_buckets;
+        uint64_t sub = index % sub_buckets;
+        if (group == 0) {
+            return sub;
+        }
+        unsigned shift = static_cast<unsigned>(group - 1);
+        return ((sub_buckets + sub) << shift) + ((uint64_t{1} << shift) - 1);
+    }
+
+    struct Snapshot {
+        std::vector<uint64_t> counts;
+        uint64_t total = 0;
+        uint64_t max = 0;
+
+        // Value at quantile q in [0, 1], 0 if nothing was recorded
+        uint64_t percentile(double q) const {
+            if (total == 0) {
+                return 0;
+            }
+            uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(total))));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); ++i) {
+                seen += counts[i];
+                if (seen >= rank) {
+                    return std::min(highest_equivalent(i), max);
+                }
+            }
+            return max;
+        }
+    };
+
+    // Writers must be serialized (ThreadSafeQueue records under its mutex),
+    // so an update is a relaxed load and store rather than a locked RMW;
+    // snapshot() may run concurrently and sees each counter untorn
+    void record(uint64_t value) {
+        bump(counts_[index_of(value)]);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    Snapshot snapshot() const {
+        Snapshot result;
+        result.counts.resize(bucket_count);
+        for (size_t i = 0; i < bucket_count; ++i) {
+            result.counts[i] = counts_[i].load(std::memory_order_relaxed);
+            result.total += result.counts[i];
+        }
+        result.max = max_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<uint64_t> counts_[bucket_count] = {};
+    std::atomic<uint64_t> max_{0};
+
+    static unsigned highest_bit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+        unsigned bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+};
+
+// Point-in-time copy of a queue's QueueStats. Counters are monotonic, so a
+// scraper can also derive rates from the difference of two snapshots.
+struct QueueStatsSnapshot {
+    uint64_t pushed = 0;
+    uint64_t popped = 0;
+    uint64_t expired_dropped = 0;          // Shed by pop_expired_drop()
+    size_t depth_high_water = 0;
+    uint64_t lock_acquisitions = 0;
+    uint64_t lock_contended = 0;           // Acquisitions that had to wait
+    std::chrono::nanoseconds lock_wait{0};  // Total time spent waiting for mutex_
+    std::chrono::nanoseconds lock_wait_max{0};
+    uint64_t wakeups = 0;                  // Returns from condition_.wait
+    uint64_t spurious_wakeups = 0;         // ... that found nothing to take
+    LatencyHistogram::Snapshot latency;    // Enqueue-to-dequeue, in nanoseconds
+    double elapsed_seconds = 0;            // Since the queue was constructed
+
+    double push_rate() const { return elapsed_seconds > 0 ? static_cast<double>(pushed) / elapsed_seconds : 0.0; }
+    double pop_rate() const { return elapsed_seconds > 0 ? static_cast<double>(popped) / elapsed_seconds : 0.0; }
+};
+
+// Writes a snapshot in the Prometheus text exposition format
+inline void write_metrics(std::ostream& out, const QueueStatsSnapshot& s, const std::string& prefix = "queue") {
+    out << prefix << "_pushed_total " << s.pushed << "\n"
+        << prefix << "_popped_total " << s.popped << "\n"
+        << prefix << "_expired_dropped_total " << s.expired_dropped << "\n"
+        << prefix << "_depth_high_water " << s.depth_high_water << "\n"
+        << prefix << "_lock_acquisitions_total " << s.lock_acquisitions << "\n"
+        << prefix << "_lock_contended_total " << s.lock_contended << "\n"
+        << prefix << "_lock_wait_ns_total " << s.lock_wait.count() << "\n"
+        << prefix << "_lock_wait_ns_max " << s.lock_wait_max.count() << "\n"
+        << prefix << "_wakeups_total " << s.wakeups << "\n"
+        << prefix << "_spurious_wakeups_total " << s.spurious_wakeups << "\n";
+    for (double q : {0.5, 0.9, 0.99, 0.999}) {
+        out << prefix << "_latency_ns{quantile=\"" << q << "\"} " << s.latency.percentile(q) << "\n";
+    }
+    out << prefix << "_latency_ns_max " << s.latency.max << "\n"
+        << prefix << "_latency_ns_count " << s.latency.total << "\n"
+        << prefix << "_push_rate " << s.push_rate() << "\n"
+        << prefix << "_pop_rate " << s.pop_rate() << "\n";
+}
+
+// Stats policy for ThreadSafeQueue: NoQueueStats (the default) compiles
+// every hook away and leaves the queue's storage and locking exactly as
+// without instrumentation. QueueStats timestamps each item on push and
+// times every acquisition of the queue's mutex. Hooks are only called with
+// that mutex held.
+struct NoQueueStats {
+    static constexpr bool enabled = false;
+};
+
+class QueueStats {
+public:
+    static constexpr bool enabled = true;
+    using clock = std::chrono::steady_clock;
+
+    void on_lock(clock::duration waited, bool contended) {
+        auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(waited).count());
+        LatencyHistogram::bump(lock_acquisitions_);
+        if (contended) {
+            LatencyHistogram::bump(lock_contended_);
+            LatencyHistogram::bump(lock_wait_ns_, ns);
+            if (ns > lock_wait_max_ns_.load(std::memory_order_relaxed)) {
+                lock_wait_max_ns_.store(ns, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void on_push(size_t count, size_t depth) {
+        LatencyHistogram::bump(pushed_, count);
+        if (depth > depth_high_water_.load(std::memory_order_relaxed)) {
+            depth_high_water_.store(depth, std::memory_order_relaxed);
+        }
+    }
+
+    void on_pop(clock::time_point enqueued, clock::time_point now) {
+        LatencyHistogram::bump(popped_);
+        auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(now - enqueued).count();
+        latency_.record(static_cast<uint64_t>(std::max<decltype(waited)>(waited, 0)));
+    }
+
+    void on_expired(size_t count) {
+        LatencyHistogram::bump(expired_dropped_, count);
+    }
+
+    void on_wakeup(bool spurious) {
+        LatencyHistogram::bump(wakeups_);
+        if (spurious) {
+            LatencyHistogram::bump(spurious_wakeups_);
+        }
+    }
+
+    QueueStatsSnapshot snapshot() const {
+        QueueStatsSnapshot s;
+        s.pushed = pushed_.load(std::memory_order_relaxed);
+        s.popped = popped_.load(std::memory_order_relaxed);
+        s.expired_dropped = expired_dropped_.load(std::memory_order_relaxed);
+        s.depth_high_water = static_cast<size_t>(depth_high_water_.load(std::memory_order_relaxed));
+        s.lock_acquisitions = lock_acquisitions_.load(std::memory_order_relaxed);
+        s.lock_contended = lock_contended_.load(std::memory_order_relaxed);
+        s.lock_wait = std::chrono::nanoseconds(lock_wait_ns_.load(std::memory_order_relaxed));
+        s.lock_wait_max = std::chrono::nanoseconds(lock_wait_max_ns_.load(std::memory_order_relaxed));
+        s.wakeups = wakeups_.load(std::memory_order_relaxed);
+        s.spurious_wakeups = spurious_wakeups_.load(std::memory_order_relaxed);
+        s.latency = latency_.snapshot();
+        s.elapsed_seconds = std::chrono::duration<double>(clock::now() - started_).count();
+        return s;
+    }
+
+private:
+    clock::time_point started_ = clock::now();
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> popped_{0};
+    std::atomic<uint64_t> expired_dropped_{0};
+    std::atomic<uint64_t> depth_high_water_{0};
+    std::atomic<uint64_t> lock_acquisitions_{0};
+    std::atomic<uint64_t> lock_contended_{0};
+    std::atomic<uint64_t> lock_wait_ns_{0};
+    std::atomic<uint64_t> lock_wait_max_ns_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> spurious_wakeups_{0};
+    LatencyHistogram latency_;
+};
+
 // ============================================================================
+// Scheduling Order (FIFO or D-ary Heap Storage for ThreadSafeQueue)
+// ============================================================================
+
+// Binary heap generalized to Arity children per node, stored in one vector.
+// A wider node makes the tree shallower, and a node's children are adjacent
+// in memory (four 16-byte nodes per cache line for small items), so a pop
+// touches fewer cache lines than with std::priority_queue. Items that
+// compare equal come out in insertion order. Before(a, b) is true when a
+// should be popped before b. Exposes the subset of std::queue's interface
+// that ThreadSafeQueue uses, with front() being the next item to pop.
+template<typename T, typename Before, size_t Arity = 4>
+class DaryHeap {
+    static_assert(Arity >= 2, "a heap node needs at least two children");
 
+private:
+    struct Node {
+        T value;
+        uint64_t sequence;  // Insertion order, breaks ties
+    };
+
+    std::vector<Node> nodes_;
+    uint64_t next_sequence_ = 0;
+    Before before_;
+
+    bool node_before(const Node& a, const Node& b) const {
+        if (before_(a.value, b.value)) {
+            return true;
+        }
+        if (before_(b.value, a.value)) {
+            return false;
+        }
+        return a.sequence < b.sequence;
+    }
+
+    // Slide parents down into the hole until `node` fits there
+    void sift_up(size_t hole, Node node) {
+        while (hole > 0) {
+            size_t parent = (hole - 1) / Arity;
+            if (!node_before(node, nodes_[parent])) {
+                break;
+            }
+            nodes_[hole] = std::move(nodes_[parent]);
+            hole = parent;
+        }
+        nodes_[hole] = std::move(node);
+    }
+
+    // Pull the earliest child up into the hole until `node` fits there
+    void sift_down(size_t hole, Node node) {
+        const size_t count = nodes_.size();
+        for (;;) {
+            size_t first = hole * Arity + 1;
+            if (first >= count) {
+                break;
+            }
+            size_t last = std::min(first + Arity, count);
+            size_t best = first;
+            for (size_t child = first + 1; child < last; ++child) {
+                if (node_before(nodes_[child], nodes_[best])) {
+                    best = child;
+                }
+            }
+            if (!node_before(nodes_[best], node)) {
+                break;
+            }
+            nodes_[hole] = std::move(nodes_[best]);
+            hole = best;
+        }
+        nodes_[hole] = std::move(node);
+    }
+
+public:
+    DaryHeap() = default;
+
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        Node node{T(std::forward<Args>(args)...), next_sequence_++};
+        nodes_.push_back(std::move(node));
+        sift_up(nodes_.size() - 1, std::move(nodes_.back()));
+    }
+
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    T& front() { return nodes_.front().value; }
+    const T& front() const { return nodes_.front().value; }
+
+    void pop() {
+        Node last = std::move(nodes_.back());
+        nodes_.pop_back();
+        if (!nodes_.empty()) {
+            sift_down(0, std::move(last));
+        }
+    }
+
+    bool empty() const { return nodes_.empty(); }
+    size_t size() const { return nodes_.size(); }
+};
+
+// An item with a priority and a deadline, for ThreadSafeQueue's
+// PriorityOrder and pop_expired_drop(). Aggregate, so
+// queue.push({job, 2, now + 5ms}) works.
 template<typename T>
+struct Scheduled {
+    using clock = std::chrono::steady_clock;
+
+    T value;
+    int priority = 0;                                  // Higher pops first
+    clock::time_point deadline = clock::time_point::max();  // Stale once passed
+
+    bool expired(clock::time_point now) const { return deadline < now; }
+};
+
+template<typename T>
+struct is_scheduled : std::false_type {};
+
+template<typename T>
+struct is_scheduled<Scheduled<T>> : std::true_type {};
+
+// Higher priority first, then earliest deadline first
+struct ScheduleBefore {
+    template<typename T>
+    bool operator()(const Scheduled<T>& a, const Scheduled<T>& b) const {
+        if (a.priority != b.priority) {
+            return a.priority > b.priority;
+        }
+        return a.deadline < b.deadline;
+    }
+};
+
+// Order policies for ThreadSafeQueue: the container that holds queued
+// entries, given the entry type and a comparator over entries built from
+// Before (which compares items)
+struct FifoOrder {
+    template<typename Entry, typename EntryBefore>
+    using container = std::queue<Entry>;
+};
+
+template<size_t Arity = 4, typename BeforeT = ScheduleBefore>
+struct PriorityOrder {
+    using Before = BeforeT;
+
+    template<typename Entry, typename EntryBefore>
+    using container = DaryHeap<Entry, EntryBefore, Arity>;
+};
+
+// ============================================================================
+// Thread-Safe Queue Implementation
+// ============================================================================
+
+// Hint to the CPU that we are busy-waiting (lets the sibling hyperthread run)
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Busy-wait step for lock-free queues: pause for a few rounds, then yield so
+// a waiter sharing a core with the other side cannot starve it
+class Backoff {
+private:
+    static constexpr size_t spin_limit_ = 64;
+    size_t count_ = 0;
+
+public:
+    void pause() {
+        if (count_ < spin_limit_) {
+            ++count_;
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+// How a blocking pop waits for an item: spin for a bounded number of
+// iterations without touching the mutex, then park on the condition variable.
+// The default (no spinning) parks immediately.
+struct WaitPolicy {
+    size_t spin_iterations = 0;
+};
+
+// Stats = QueueStats turns on instrumentation (see stats()); the default
+// NoQueueStats builds the plain queue. Order = PriorityOrder<> pops by
+// priority and deadline from a d-ary heap instead of in FIFO order; with
+// T = Scheduled<U>, pop_expired_drop() sheds items whose deadline passed.
+template<typename T, typename Stats = NoQueueStats, typename Order = FifoOrder>
 class ThreadSafeQueue {
 private:
+    using clock = std::chrono::steady_clock;
+
+    // With stats on, each item carries its enqueue time
+    struct Stamped {
+        T item;
+        clock::time_point enqueued;
+
+        template<typename U>
+        Stamped(U&& value, clock::time_point when) : item(std::forward<U>(value)), enqueued(when) {}
+    };
+    struct NoStamp {};
+    using Entry = std::conditional_t<Stats::enabled, Stamped, T>;
+    using Stamp = std::conditional_t<Stats::enabled, clock::time_point, NoStamp>;
+
+    static const T& item_of(const Entry& entry) {
+        if constexpr (Stats::enabled) {
+            return entry.item;
+        } else {
+            return entry;
+        }
+    }
+
+    // Only instantiated for orders that compare items
+    struct EntryBefore {
+        bool operator()(const Entry& a, const Entry& b) const {
+            return typename Order::Before{}(item_of(a), item_of(b));
+        }
+    };
+
     mutable std::mutex mutex_;
-    std::queue<T> queue_;
+    typename Order::template container<Entry, EntryBefore> queue_;
     std::condition_variable condition_;
+    WaitPolicy policy_;
+    std::atomic<size_t> size_hint_{0};  // Mirrors queue_.size() for lock-free spinning
+    std::atomic<bool> closed_{false};
+    mutable Stats stats_;               // Empty by default; sits in closed_'s padding
+    size_t waiters_ = 0;                // Threads parked on condition_ (guarded by mutex_)
+
+    // Lock mutex_, timing the wait when stats are on. Uncontended locks are
+    // detected with try_lock and cost no clock reads.
+    void lock_mutex() const {
+        if constexpr (Stats::enabled) {
+            if (mutex_.try_lock()) {
+                stats_.on_lock(clock::duration::zero(), false);
+                return;
+            }
+            auto start = clock::now();
+            mutex_.lock();
+            stats_.on_lock(clock::now() - start, true);
+        } else {
+            mutex_.lock();
+        }
+    }
+
+    std::lock_guard<std::mutex> guard() const {
+        lock_mutex();
+        return std::lock_guard<std::mutex>(mutex_, std::adopt_lock);
+    }
+
+    std::unique_lock<std::mutex> unique_guard() const {
+        lock_mutex();
+        return std::unique_lock<std::mutex>(mutex_, std::adopt_lock);
+    }
+
+    static Stamp stamp() {
+        if constexpr (Stats::enabled) {
+            return clock::now();
+        } else {
+            return NoStamp{};
+        }
+    }
+
+    // Append one item (mutex_ must be held)
+    template<typename U>
+    void enqueue(U&& item, Stamp when) {
+        if constexpr (Stats::enabled) {
+            queue_.emplace(std::forward<U>(item), when);
+        } else {
+            (void)when;
+            queue_.push(std::forward<U>(item));
+        }
+    }
+
+    // Remove and return the front item (mutex_ must be held)
+    T dequeue(Stamp now) {
+        if constexpr (Stats::enabled) {
+            stats_.on_pop(queue_.front().enqueued, now);
+            T item = std::move(queue_.front().item);
+            queue_.pop();
+            return item;
+        } else {
+            (void)now;
+            T item = std::move(queue_.front());
+            queue_.pop();
+            return item;
+        }
+    }
+
+    // Bookkeeping after pushing `count` items (mutex_ must be held)
+    void pushed(size_t count) {
+        size_hint_.store(queue_.size(), std::memory_order_release);
+        if constexpr (Stats::enabled) {
+            stats_.on_push(count, queue_.size());
+        } else {
+            (void)count;
+        }
+    }
+
+    // Move up to max_items from the front of the queue (mutex_ must be held)
+    template<typename OutputIt>
+    size_t drain(OutputIt& out, size_t max_items) {
+        Stamp now = stamp();
+        size_t popped = 0;
+        while (popped < max_items && !queue_.empty()) {
+            *out++ = dequeue(now);
+            ++popped;
+        }
+        size_hint_.store(queue_.size(), std::memory_order_relaxed);
+        return popped;
+    }
+
+    T take_front() {
+        T item = dequeue(stamp());
+        size_hint_.store(queue_.size(), std::memory_order_relaxed);
+        return item;
+    }
+
+    // Discard front items whose deadline is before now (mutex_ must be held)
+    void drop_expired(clock::time_point now) {
+        size_t dropped = 0;
+        while (!queue_.empty() && item_of(queue_.front()).expired(now)) {
+            queue_.pop();
+            ++dropped;
+        }
+        if (dropped > 0) {
+            size_hint_.store(queue_.size(), std::memory_order_relaxed);
+            if constexpr (Stats::enabled) {
+                stats_.on_expired(dropped);
+            }
+        }
+    }
+
+    bool ready() const {
+        return !queue_.empty() || closed_.load(std::memory_order_relaxed);
+    }
+
+    // Spin phase of the wait policy; true if an item (or close) showed up
+    bool spin_for_item() const {
+        for (size_t i = 0; i < policy_.spin_iterations; ++i) {
+            if (size_hint_.load(std::memory_order_acquire) > 0 ||
+                closed_.load(std::memory_order_acquire)) {
+                return true;
+            }
+            cpu_relax();
+        }
+        return false;
+    }
+
+    // Park phase of the wait policy (lock must hold mutex_). With stats on,
+    // every return from condition_.wait is counted, and one that finds the
+    // queue still empty and open (an OS spurious wakeup, or an item taken
+    // by another consumer first) counts as spurious.
+    void park(std::unique_lock<std::mutex>& lock) {
+        ++waiters_;
+        if constexpr (Stats::enabled) {
+            while (!ready()) {
+                condition_.wait(lock);
+                stats_.on_wakeup(!ready());
+            }
+        } else {
+            condition_.wait(lock, [this] { return ready(); });
+        }
+        --waiters_;
+    }
+
+    template<typename Clock, typename Duration>
+    bool park_until(std::unique_lock<std::mutex>& lock,
+                    const std::chrono::time_point<Clock, Duration>& deadline) {
+        ++waiters_;
+        bool result;
+        if constexpr (Stats::enabled) {
+            while (!(result = ready())) {
+                if (condition_.wait_until(lock, deadline) == std::cv_status::timeout) {
+                    result = ready();
+                    break;
+                }
+                stats_.on_wakeup(!ready());
+            }
+        } else {
+            result = condition_.wait_until(lock, deadline, [this] { return ready(); });
+        }
+        --waiters_;
+        return result;
+    }
 
 public:
     ThreadSafeQueue() = default;
 
+    explicit ThreadSafeQueue(WaitPolicy policy) : policy_(policy) {}
+
     // Delete copy constructor and copy assignment
     ThreadSafeQueue(const ThreadSafeQueue&) = delete;
     ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
 
     // Push item (copy)
     void push(const T& item) {
+        bool wake;
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            queue_.push(item);
+            auto lock = guard();
+            enqueue(item, stamp());
+            pushed(1);
+            wake = waiters_ > 0;
+        }
+        if (wake) {
+            condition_.notify_one();
         }
-        condition_.notify_one();
     }
 
     // Push item (move)
     void push(T&& item) {
+        bool wake;
         {
-            std::lock_guard<std::mutex> lock(mutex_);
-            queue_.push(std::move(item));
+            auto lock = guard();
+            enqueue(std::move(item), stamp());
+            pushed(1);
+            wake = waiters_ > 0;
+        }
+        if (wake) {
+            condition_.notify_one();
         }
-        condition_.notify_one();
     }
 
-    // Pop with blocking wait
-    T pop() {
-        std::unique_lock<std::mutex> lock(mutex_);
+    // Pop with blocking wait, returns empty once the queue is closed and drained
+    std::optional<T> pop() {
+        spin_for_item();
+
+        auto lock = unique_guard();
         
-        // Wait until queue is not empty
+        // Wait until queue is not empty (or closed)
         // Using predicate to avoid spurious wakeups
-        condition_.wait(lock, [this] { return !queue_.empty(); });
+        if (!ready()) {
+            park(lock);
+        }
         
-        T item = std::move(queue_.front());
-        queue_.pop();
-        return item;
+        if (queue_.empty()) {
+            return std::nullopt;  // Closed
+        }
+        return take_front();
+    }
+
+    // Try pop without blocking
+    bool try_pop(T& item) {
+        auto lock = guard();
+        
+        if (queue_.empty()) {
+            return false;
+        }
+        
+        item = take_front();
+        return true;
+    }
+
+    // Try pop with optional (C++17)
+    std::optional<T> try_pop() {
+        auto lock = guard();
+        
+        if (queue_.empty()) {
+            return std::nullopt;
+        }
+        
+        return take_front();
+    }
+
+    // Pop with timeout (returns empty on timeout or once closed and drained)
+    template<typename Rep, typename Period>
+    std::optional<T> pop_timeout(const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        spin_for_item();
+
+        auto lock = unique_guard();
+        
+        if (park_until(lock, deadline) && !queue_.empty()) {
+            return take_front();
+        }
+        
+        return std::nullopt;
+    }
+
+    // pop_timeout() that never hands out stale work: items at the front
+    // whose deadline has passed are destroyed unprocessed (counted in
+    // stats() if enabled) and the wait continues for a live one. With
+    // PriorityOrder an expired item is shed when it reaches the front, so
+    // it holds memory until then but never reaches a consumer.
+    template<typename Rep, typename Period>
+    std::optional<T> pop_expired_drop(const std::chrono::duration<Rep, Period>& timeout) {
+        static_assert(is_scheduled<T>::value, "pop_expired_drop() needs items of type Scheduled<U>");
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        spin_for_item();
+
+        auto lock = unique_guard();
+
+        while (park_until(lock, deadline)) {
+            drop_expired(clock::now());
+            if (!queue_.empty()) {
+                return take_front();
+            }
+            if (closed_.load(std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // Push a range of items under a single lock with a single notification
+    // (items are moved out of the range; pass const iterators to copy)
+    template<typename InputIt>
+    void push_bulk(InputIt first, InputIt last) {
+        size_t count = 0;
+        bool wake;
+        {
+            auto lock = guard();
+            Stamp now = stamp();
+            for (; first != last; ++first, ++count) {
+                enqueue(std::move(*first), now);
+            }
+            pushed(count);
+            wake = waiters_ > 0;
+        }
+
+        if (!wake) {
+            return;
+        }
+        if (count == 1) {
+            condition_.notify_one();
+        } else if (count > 1) {
+            condition_.notify_all();
+        }
+    }
+
+    // Pop up to max_items without blocking, returns the number popped
+    template<typename OutputIt>
+    size_t try_pop_bulk(OutputIt out, size_t max_items) {
+        auto lock = guard();
+        return drain(out, max_items);
+    }
+
+    // Wait up to timeout for at least one item, then pop up to max_items
+    template<typename OutputIt, typename Rep, typename Period>
+    size_t pop_bulk(OutputIt out, size_t max_items,
+                    const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        spin_for_item();
+
+        auto lock = unique_guard();
+
+        if (!park_until(lock, deadline)) {
+            return 0;
+        }
+        return drain(out, max_items);
+    }
+
+    // Check if queue is empty
+    bool empty() const {
+        auto lock = guard();
+        return queue_.empty();
+    }
+
+    // Get size
+    size_t size() const {
+        auto lock = guard();
+        return queue_.size();
+    }
+
+    // Notify all waiting threads (wakes them, but they go back to waiting
+    // if the queue is still empty; use close() to shut consumers down)
+    void notify_all() {
+        condition_.notify_all();
+    }
+
+    // Shut down: wake every waiter; blocking pops drain the remaining items
+    // and then return empty instead of waiting
+    void close() {
+        {
+            auto lock = guard();
+            closed_.store(true, std::memory_order_release);
+        }
+        condition_.notify_all();
+    }
+
+    bool closed() const {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    // Counters, lock wait and latency histogram so far; safe to call from
+    // any thread while the queue is in use, and does not take mutex_.
+    // Only available with Stats = QueueStats. The time a woken consumer
+    // spends reacquiring mutex_ inside condition_.wait is not counted as
+    // lock wait.
+    QueueStatsSnapshot stats() const {
+        static_assert(Stats::enabled, "stats() needs ThreadSafeQueue<T, QueueStats>");
+        return stats_.snapshot();
+    }
+};
+
+// ============================================================================
+// Lock-Free Bounded MPMC Queue (Ring Buffer with Per-Slot Sequences)
+// ============================================================================
+
+// Each slot carries a sequence number that tells producers and consumers
+// whose turn it is:
+//   sequence == pos       -> slot is free for the producer claiming pos
+//   sequence == pos + 1   -> slot holds the item for the consumer claiming pos
+// Producers and consumers only contend on their own position counter, and
+// every slot lives on its own cache line, so no lock and no allocation is
+// involved after construction.
+template<typename T, size_t Capacity>
+class BoundedMPMCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "BoundedMPMCQueue capacity must be a power of two");
+
+private:
+    struct alignas(cache_line_size) Slot {
+        std::atomic<size_t> sequence;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        T* ptr() { return reinterpret_cast<T*>(&storage); }
+    };
+
+    static constexpr size_t mask_ = Capacity - 1;
+
+    Slot buffer_[Capacity];
+    alignas(cache_line_size) std::atomic<size_t> enqueue_pos_{0};
+    alignas(cache_line_size) std::atomic<size_t> dequeue_pos_{0};
+
+    // Claim a slot for writing, construct the item in place and publish it
+    template<typename U>
+    bool emplace(U&& item) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;) {
+            slot = &buffer_[pos & mask_];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Queue is full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (slot->ptr()) T(std::forward<U>(item));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Claim a filled slot, move the item into sink and hand the slot back to producers
+    template<typename Sink>
+    bool dequeue(Sink&& sink) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Slot* slot;
+
+        for (;;) {
+            slot = &buffer_[pos & mask_];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Queue is empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        sink(std::move(*slot->ptr()));
+        slot->ptr()->~T();
+        slot->sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+public:
+    BoundedMPMCQueue() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            buffer_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Destroy any items that were never popped
+    ~BoundedMPMCQueue() {
+        size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+        for (size_t pos = head; pos != tail; ++pos) {
+            buffer_[pos & mask_].ptr()->~T();
+        }
+    }
+
+    // Delete copy constructor and copy assignment
+    BoundedMPMCQueue(const BoundedMPMCQueue&) = delete;
+    BoundedMPMCQueue& operator=(const BoundedMPMCQueue&) = delete;
+
+    // Try push without blocking (returns false if the ring is full)
+    bool try_push(const T& item) {
+        return emplace(item);
+    }
+
+    bool try_push(T&& item) {
+        return emplace(std::move(item));
+    }
+
+    // Push item, yielding while the ring is full
+    void push(const T& item) {
+        while (!emplace(item)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void push(T&& item) {
+        while (!emplace(std::move(item))) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Try pop without blocking
+    bool try_pop(T& item) {
+        return dequeue([&item](T&& value) { item = std::move(value); });
+    }
+
+    // Try pop with optional (C++17)
+    std::optional<T> try_pop() {
+        std::optional<T> result;
+        dequeue([&result](T&& value) { result.emplace(std::move(value)); });
+        return result;
+    }
+
+    // Pop with timeout (there is no condition variable, so wait by yielding)
+    template<typename Rep, typename Period>
+    std::optional<T> pop_timeout(const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        for (;;) {
+            if (auto item = try_pop()) {
+                return item;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return std::nullopt;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Approximate size (exact only when no other thread is pushing or popping)
+    size_t size() const {
+        size_t head = dequeue_pos_.load(std::memory_order_acquire);
+        size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+};
+
+// ============================================================================
+// Single-Producer/Single-Consumer Queue
+// ============================================================================
+
+// Exactly one thread may push and exactly one thread may pop. Each side
+// owns its index and keeps a cached copy of the other side's index, so the
+// shared cache line is only read when the cached value says the ring looks
+// full (producer) or empty (consumer). There are no RMW operations, only
+// acquire loads and release stores.
+template<typename T, size_t Capacity>
+class SPSCQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SPSCQueue capacity must be a power of two");
+
+private:
+    using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+    static constexpr size_t mask_ = Capacity - 1;
+
+    // Consumer side
+    alignas(cache_line_size) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+
+    // Producer side
+    alignas(cache_line_size) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+
+    alignas(cache_line_size) std::atomic<bool> closed_{false};
+    alignas(cache_line_size) Storage buffer_[Capacity];
+
+    T* slot(size_t index) {
+        return reinterpret_cast<T*>(&buffer_[index & mask_]);
+    }
+
+    template<typename U>
+    bool emplace(U&& item) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == Capacity) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == Capacity) {
+                return false;  // Queue is full
+            }
+        }
+
+        new (slot(tail)) T(std::forward<U>(item));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename Sink>
+    bool dequeue(Sink&& sink) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;  // Queue is empty
+            }
+        }
+
+        sink(std::move(*slot(head)));
+        slot(head)->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+public:
+    SPSCQueue() = default;
+
+    // Destroy any items that were never popped
+    ~SPSCQueue() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        for (; head != tail; ++head) {
+            slot(head)->~T();
+        }
+    }
+
+    // Delete copy constructor and copy assignment
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    // Producer: try push without blocking (returns false if the ring is full)
+    bool try_push(const T& item) {
+        return emplace(item);
+    }
+
+    bool try_push(T&& item) {
+        return emplace(std::move(item));
+    }
+
+    // Producer: push item, spinning while the ring is full
+    void push(const T& item) {
+        Backoff backoff;
+        while (!emplace(item)) {
+            backoff.pause();
+        }
+    }
+
+    void push(T&& item) {
+        Backoff backoff;
+        while (!emplace(std::move(item))) {
+            backoff.pause();
+        }
+    }
+
+    // Consumer: try pop without blocking
+    bool try_pop(T& item) {
+        return dequeue([&item](T&& value) { item = std::move(value); });
+    }
+
+    std::optional<T> try_pop() {
+        std::optional<T> result;
+        dequeue([&result](T&& value) { result.emplace(std::move(value)); });
+        return result;
+    }
+
+    // Consumer: pop with busy wait, returns empty once closed and drained
+    std::optional<T> pop() {
+        Backoff backoff;
+        for (;;) {
+            if (auto item = try_pop()) {
+                return item;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                // Pick up anything pushed just before close()
+                return try_pop();
+            }
+            backoff.pause();
+        }
+    }
+
+    // Consumer: pop with timeout (returns empty on timeout or once closed and drained)
+    template<typename Rep, typename Period>
+    std::optional<T> pop_timeout(const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        for (;;) {
+            if (auto item = try_pop()) {
+                return item;
+            }
+            if (closed_.load(std::memory_order_acquire)) {
+                return try_pop();
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return std::nullopt;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Producer: no more items will be pushed
+    void close() {
+        closed_.store(true, std::memory_order_release);
+    }
+
+    // Approximate size (exact only when called from the producer or consumer thread)
+    size_t size() const {
+        size_t tail = tail_.load(std::memory_order_acquire);
+        size_t head = head_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+};
+
+// ============================================================================
+// Chase-Lev Work-Stealing Deque
+// ============================================================================
+
+// The owning worker pushes and pops at the bottom without any lock; other
+// threads steal from the top with a single CAS. Only the last remaining
+// item needs a CAS on the owner side. Arrays replaced on growth are kept
+// until the deque is destroyed, so a concurrent thief never reads freed memory.
+template<typename T>
+class ChaseLevDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "ChaseLevDeque stores trivially copyable handles");
+
+private:
+    struct Array {
+        size_t capacity;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(size_t cap) : capacity(cap), slots(new std::atomic<T>[cap]) {}
+
+        T get(int64_t index) const {
+            return slots[static_cast<size_t>(index) & (capacity - 1)].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T value) {
+            slots[static_cast<size_t>(index) & (capacity - 1)].store(value, std::memory_order_relaxed);
+        }
+    };
+
+    alignas(cache_line_size) std::atomic<int64_t> top_{0};
+    alignas(cache_line_size) std::atomic<int64_t> bottom_{0};
+    std::atomic<Array*> array_;
+    std::vector<std::unique_ptr<Array>> arrays_;  // Current and retired arrays (owner only)
+
+    Array* grow(Array* old, int64_t top, int64_t bottom) {
+        auto bigger = std::make_unique<Array>(old->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        Array* raw = bigger.get();
+        arrays_.push_back(std::move(bigger));
+        array_.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+public:
+    explicit ChaseLevDeque(size_t initial_capacity = 64) {
+        arrays_.push_back(std::make_unique<Array>(initial_capacity));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    // Owner only
+    void push(T value) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+
+        if (bottom - top > static_cast<int64_t>(array->capacity) - 1) {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, value);
+        bottom_.store(bottom + 1, std::memory_order_release);
+    }
+
+    // Owner only (LIFO end, keeps recently spawned work hot in cache)
+    bool pop(T& value) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return false;  // Deque was empty
+        }
+
+        value = array->get(bottom);
+        if (top == bottom) {
+            // Last item: race against thieves for it
+            bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread (FIFO end, takes the oldest and usually largest piece of work)
+    bool steal(T& value) {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return false;
+        }
+
+        Array* array = array_.load(std::memory_order_acquire);
+        value = array->get(top);
+        return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    }
+
+    bool empty() const {
+        return bottom_.load(std::memory_order_relaxed) <= top_.load(std::memory_order_relaxed);
+    }
+};
+
+// ============================================================================
+// Work-Stealing Thread Pool
+// ============================================================================
+
+// Tasks spawned from a worker go to that worker's own deque; tasks submitted
+// from outside go through a shared ThreadSafeQueue. Idle workers steal from
+// random victims before parking, so the shared lock is only touched by
+// external submissions and never by recursive work such as parallel_for.
+//
+// There is no shared count of pending tasks: whether work exists is read
+// off the deques and the injection queue themselves. A worker about to park
+// announces itself in idle_, fences and rescans; a submitter fences after
+// publishing and only signals if idle_ is non-zero. That fence pair makes
+// one of the two see the other, so a task is never stranded, and the shared
+// idle_/epoch_ line is written only when a worker parks or is woken.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Worker {
+        ChaseLevDeque<Task*> deque;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    ThreadSafeQueue<Task*> injection_queue_;
+
+    alignas(cache_line_size) std::atomic<size_t> idle_{0};  // Workers parking or parked
+    std::atomic<uint64_t> epoch_{0};  // Bumped under sleep_mutex_ to wake parked workers
+    std::atomic<bool> stop_{false};
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+
+    // Identifies the pool and worker slot of the current thread
+    static inline thread_local WorkStealingPool* current_pool_ = nullptr;
+    static inline thread_local size_t current_index_ = 0;
+    static inline thread_local uint32_t rng_state_ = 0;
+
+    static uint32_t next_random() {
+        // xorshift32: a cheap per-thread generator is all victim selection needs
+        uint32_t x = rng_state_ ? rng_state_ : 0x9E3779B9u;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        rng_state_ = x;
+        return x;
+    }
+
+    bool on_worker_thread() const {
+        return current_pool_ == this;
+    }
+
+    void enqueue(Task* task) {
+        if (on_worker_thread()) {
+            workers_[current_index_]->deque.push(task);
+        } else {
+            injection_queue_.push(task);
+        }
+
+        // Pairs with the fence in park(): either this load sees the parking
+        // worker, or that worker's rescan sees the task just published
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (idle_.load(std::memory_order_relaxed) > 0) {
+            wake(false);
+        }
+    }
+
+    void wake(bool all) {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            epoch_.fetch_add(1, std::memory_order_release);
+        }
+        if (all) {
+            sleep_cv_.notify_all();
+        } else {
+            sleep_cv_.notify_one();
+        }
+    }
+
+    // Whether any task is queued anywhere; only called on the way to parking
+    // or exiting, since it takes the injection queue's lock
+    bool has_work() const {
+        if (!injection_queue_.empty()) {
+            return true;
+        }
+        for (const auto& worker : workers_) {
+            if (!worker->deque.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Sleep until enqueue() or the destructor bumps epoch_, unless work shows
+    // up while announcing; returns immediately in that case
+    void park() {
+        idle_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        // Acquire: a snapshot that already includes a bump also sees the
+        // task published before it, so the rescan below cannot miss that task
+        uint64_t seen = epoch_.load(std::memory_order_acquire);
+        if (!has_work() && !stop_.load(std::memory_order_acquire)) {
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            sleep_cv_.wait(lock, [this, seen] {
+                return epoch_.load(std::memory_order_relaxed) != seen || stop_.load(std::memory_order_acquire);
+            });
+        }
+        idle_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    Task* find_task() {
+        Task* task = nullptr;
+
+        if (on_worker_thread() && workers_[current_index_]->deque.pop(task)) {
+            return task;
+        }
+        if (injection_queue_.try_pop(task)) {
+            return task;
+        }
+
+        // Start at a random victim so thieves spread out across workers
+        const size_t count = workers_.size();
+        const size_t start = next_random() % count;
+        for (size_t i = 0; i < count; ++i) {
+            size_t victim = (start + i) % count;
+            if (on_worker_thread() && victim == current_index_) {
+                continue;
+            }
+            if (workers_[victim]->deque.steal(task)) {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    void run(Task* task) {
+        std::unique_ptr<Task> owned(task);
+        (*owned)();
+    }
+
+    void worker_loop(size_t index) {
+        current_pool_ = this;
+        current_index_ = index;
+        rng_state_ = static_cast<uint32_t>(index * 2654435761u + 1);
+
+        for (;;) {
+            if (Task* task = find_task()) {
+                run(task);
+                continue;
+            }
+
+            // A failed steal can be a lost race rather than an empty deque,
+            // so only exit once a scan finds nothing queued anywhere
+            if (stop_.load(std::memory_order_acquire)) {
+                if (!has_work()) {
+                    return;
+                }
+                continue;
+            }
+            park();
+        }
     }
 
-    // Try pop without blocking
-    bool try_pop(T& item) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (queue_.empty()) {
-            return false;
+    // Split [begin, end) in halves, keep the left half and expose the right
+    // half to thieves, until the piece is no larger than grain
+    template<typename Function>
+    void run_range(size_t begin, size_t end, size_t grain, Function* fn,
+                   std::atomic<size_t>* remaining, std::atomic<bool>* failed,
+                   std::exception_ptr* error) {
+        while (end - begin > grain) {
+            size_t mid = begin + (end - begin) / 2;
+            enqueue(new Task([this, mid, end, grain, fn, remaining, failed, error] {
+                run_range(mid, end, grain, fn, remaining, failed, error);
+            }));
+            end = mid;
         }
-        
-        item = std::move(queue_.front());
-        queue_.pop();
-        return true;
+
+        if (!failed->load(std::memory_order_relaxed)) {
+            try {
+                for (size_t i = begin; i < end; ++i) {
+                    (*fn)(i);
+                }
+            } catch (...) {
+                if (!failed->exchange(true)) {
+                    *error = std::current_exception();
+                }
+            }
+        }
+        remaining->fetch_sub(end - begin, std::memory_order_acq_rel);
     }
 
-    // Try pop with optional (C++17)
-    std::optional<T> try_pop() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        
-        if (queue_.empty()) {
-            return std::nullopt;
+public:
+    explicit WorkStealingPool(size_t num_threads = std::thread::hardware_concurrency()) {
+        if (num_threads == 0) {
+            num_threads = 1;
+        }
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+        // Start threads only once every deque exists, since workers steal from all of them
+        for (size_t i = 0; i < num_threads; ++i) {
+            workers_[i]->thread = std::thread(&WorkStealingPool::worker_loop, this, i);
         }
-        
-        T item = std::move(queue_.front());
-        queue_.pop();
-        return item;
     }
 
-    // Pop with timeout
-    template<typename Rep, typename Period>
-    std::optional<T> pop_timeout(const std::chrono::duration<Rep, Period>& timeout) {
-        std::unique_lock<std::mutex> lock(mutex_);
-        
-        if (condition_.wait_for(lock, timeout, [this] { return !queue_.empty(); })) {
-            T item = std::move(queue_.front());
-            queue_.pop();
-            return item;
+    // Runs every task already submitted, then joins the workers
+    ~WorkStealingPool() {
+        stop_.store(true, std::memory_order_release);
+        wake(true);
+        for (auto& worker : workers_) {
+            worker->thread.join();
         }
-        
-        return std::nullopt;
     }
 
-    // Check if queue is empty
-    bool empty() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.empty();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Schedule a callable and get its result (or exception) through a future
+    template<typename F, typename... Args>
+    auto submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
+        using Result = std::invoke_result_t<F, Args...>;
+
+        // std::function needs a copyable target, so share the packaged_task
+        auto task = std::make_shared<std::packaged_task<Result()>>(
+            [fn = std::forward<F>(f), bound = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(std::move(fn), std::move(bound));
+            });
+        std::future<Result> result = task->get_future();
+        enqueue(new Task([task] { (*task)(); }));
+        return result;
     }
 
-    // Get size
-    size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return queue_.size();
+    // Call fn(i) for every i in [begin, end), in pieces of at most grain
+    // indices. The calling thread helps execute work until the range is done,
+    // so it is safe to call from inside a pool task. Rethrows the first
+    // exception thrown by fn.
+    template<typename Function>
+    void parallel_for(size_t begin, size_t end, size_t grain, Function fn) {
+        if (begin >= end) {
+            return;
+        }
+        if (grain == 0) {
+            grain = 1;
+        }
+
+        std::atomic<size_t> remaining{end - begin};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+
+        run_range(begin, end, grain, &fn, &remaining, &failed, &error);
+
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (Task* task = find_task()) {
+                run(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
     }
 
-    // Notify all waiting threads (useful for shutdown)
-    void notify_all() {
-        condition_.notify_all();
+    size_t thread_count() const {
+        return workers_.size();
     }
 };
 
@@ -137,6 +1596,10 @@ public:
     }
 };
 
+// Other exercises include this file for its data structures; they define
+// EXERCISE_3_NO_MAIN to leave out the tests and main()
+#ifndef EXERCISE_3_NO_MAIN
+
 // ============================================================================
 // Test Functions
 // ============================================================================
@@ -157,7 +1620,7 @@ void test_single_producer_single_consumer() {
 
     std::thread consumer([&queue, &consumed]() {
         for (int i = 0; i < 10; ++i) {
-            int value = queue.pop();
+            int value = queue.pop().value();
             consumed.push_back(value);
             std::cout << "  Consumed: " << value << std::endl;
         }
@@ -177,8 +1640,8 @@ void test_multiple_producers_multiple_consumers() {
     std::cout << "=== Test 2: Multiple Producers, Multiple Consumers ===\n";
     
     ThreadSafeQueue<int> queue;
-    ThreadSafeCounter produced_count;
-    ThreadSafeCounter consumed_count;
+    ShardedCounter produced_count;
+    ShardedCounter consumed_count;  // Only read after join, so nobody polls a shared line
     const int items_per_producer = 20;
     const int num_producers = 3;
     const int num_consumers = 4;
@@ -197,32 +1660,29 @@ void test_multiple_producers_multiple_consumers() {
         });
     }
 
-    // Start consumers
+    // Start consumers: each blocks in pop() until the queue is closed and
+    // drained, instead of polling a shared count
     for (int i = 0; i < num_consumers; ++i) {
-        consumers.emplace_back([&queue, &consumed_count, i]() {
-            int value;
-            while (consumed_count.get() < num_producers * items_per_producer) {
-                if (queue.try_pop(value)) {
-                    consumed_count.increment();
-                } else {
-                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                }
+        consumers.emplace_back([&queue, &consumed_count]() {
+            while (queue.pop()) {
+                consumed_count.increment();
             }
         });
     }
 
-    // Wait for all producers
+    // Wait for all producers, then let the consumers finish what is queued
     for (auto& t : producers) {
         t.join();
     }
+    queue.close();
 
     // Wait for all consumers
     for (auto& t : consumers) {
         t.join();
     }
 
-    std::cout << "  Produced: " << produced_count.get() << " items\n";
-    std::cout << "  Consumed: " << consumed_count.get() << " items\n";
+    std::cout << "  Produced: " << produced_count.sum() << " items\n";
+    std::cout << "  Consumed: " << consumed_count.sum() << " items\n";
     std::cout << "  Queue size: " << queue.size() << std::endl << std::endl;
 }
 
@@ -285,7 +1745,7 @@ void test_move_semantics() {
     std::cout << "  Vector size after move: " << vec.size() << " (should be 0)" << std::endl;
 
     // Pop with move
-    std::vector<int> popped = queue.pop();
+    std::vector<int> popped = queue.pop().value();
     std::cout << "  Popped vector size: " << popped.size() << std::endl;
     std::cout << "  Popped vector contents: ";
     for (int val : popped) {
@@ -346,6 +1806,628 @@ void test_concurrent_stress() {
     std::cout << "  All items processed: " << (total_produced == total_consumed ? "yes" : "no") << std::endl << std::endl;
 }
 
+void test_bounded_mpmc_queue() {
+    std::cout << "=== Test 7: Lock-Free Bounded MPMC Queue ===\n";
+
+    BoundedMPMCQueue<std::string, 4> queue;
+    std::cout << "  Capacity: " << queue.capacity() << "\n";
+
+    // Fill the ring, then verify a full ring rejects further pushes
+    queue.push("one");
+    queue.push("two");
+    queue.push("three");
+    queue.push("four");
+    std::cout << "  try_push on full ring: " << (queue.try_push("five") ? "accepted" : "rejected") << "\n";
+
+    // Items come out in FIFO order
+    while (auto item = queue.try_pop()) {
+        std::cout << "  Popped: " << item.value() << std::endl;
+    }
+
+    // Wrap around the ring several times
+    int wrapped = 0;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            queue.push(std::to_string(round * 3 + i));
+        }
+        std::string value;
+        while (queue.try_pop(value)) {
+            ++wrapped;
+        }
+    }
+    std::cout << "  Items passed through after wrap-around: " << wrapped << "\n";
+
+    auto result = queue.pop_timeout(std::chrono::milliseconds(50));
+    std::cout << "  Timeout pop (empty ring): " << (result.has_value() ? result.value() : "timeout") << "\n";
+    std::cout << "  Queue empty: " << (queue.empty() ? "yes" : "no") << std::endl << std::endl;
+}
+
+void test_bounded_mpmc_stress() {
+    std::cout << "=== Test 8: Bounded MPMC Concurrent Stress Test ===\n";
+
+    // Same workload as test_concurrent_stress, on the lock-free ring
+    BoundedMPMCQueue<int, 1024> queue;
+    const int num_threads = 10;
+    const int items_per_thread = 100;
+    std::atomic<int> total_produced{0};
+    std::atomic<int> total_consumed{0};
+    std::atomic<long long> checksum{0};
+
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&queue, &total_produced, &total_consumed, &checksum, i, items_per_thread]() {
+            for (int j = 0; j < items_per_thread; ++j) {
+                queue.push(i * items_per_thread + j);
+                total_produced.fetch_add(1);
+            }
+
+            int consumed = 0;
+            while (consumed < items_per_thread) {
+                int value;
+                if (queue.try_pop(value)) {
+                    consumed++;
+                    total_consumed.fetch_add(1);
+                    checksum.fetch_add(value);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    const long long total = static_cast<long long>(num_threads) * items_per_thread;
+    std::cout << "  Threads: " << num_threads << "\n";
+    std::cout << "  Total produced: " << total_produced.load() << "\n";
+    std::cout << "  Total consumed: " << total_consumed.load() << "\n";
+    std::cout << "  Final queue size: " << queue.size() << "\n";
+    std::cout << "  Time elapsed: " << elapsed.count() << "us\n";
+    std::cout << "  No items lost or duplicated: "
+              << (checksum.load() == total * (total - 1) / 2 ? "yes" : "no") << std::endl << std::endl;
+}
+
+void test_bulk_operations() {
+    std::cout << "=== Test 9: Bulk Push/Pop ===\n";
+
+    ThreadSafeQueue<int> queue;
+    const int num_batches = 10;
+    const int batch_size = 100;
+    const int num_consumers = 3;
+    std::atomic<int> total_consumed{0};
+    std::atomic<int> total_batches{0};
+
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < num_consumers; ++i) {
+        consumers.emplace_back([&queue, &total_consumed, &total_batches, num_batches, batch_size]() {
+            std::vector<int> batch;
+            while (total_consumed.load() < num_batches * batch_size) {
+                batch.clear();
+                size_t n = queue.pop_bulk(std::back_inserter(batch), 64, std::chrono::milliseconds(10));
+                if (n > 0) {
+                    total_consumed.fetch_add(static_cast<int>(n));
+                    total_batches.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    // Each batch costs one lock round-trip and one notification
+    for (int b = 0; b < num_batches; ++b) {
+        std::vector<int> items(batch_size);
+        for (int j = 0; j < batch_size; ++j) {
+            items[j] = b * batch_size + j;
+        }
+        queue.push_bulk(items.begin(), items.end());
+    }
+
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    std::cout << "  Pushed: " << num_batches * batch_size << " items in " << num_batches << " batches\n";
+    std::cout << "  Consumed: " << total_consumed.load() << " items in " << total_batches.load() << " batches\n";
+
+    // Non-blocking bulk pop never takes more than requested
+    std::vector<int> small{1, 2, 3, 4, 5};
+    queue.push_bulk(small.begin(), small.end());
+    std::vector<int> out;
+    size_t first = queue.try_pop_bulk(std::back_inserter(out), 3);
+    size_t second = queue.try_pop_bulk(std::back_inserter(out), 3);
+    size_t third = queue.try_pop_bulk(std::back_inserter(out), 3);
+    std::cout << "  try_pop_bulk(3) x3 returned: " << first << ", " << second << ", " << third << "\n";
+    std::cout << "  Popped in order: ";
+    for (int val : out) {
+        std::cout << val << " ";
+    }
+    std::cout << std::endl << std::endl;
+}
+
+void test_work_stealing_pool() {
+    std::cout << "=== Test 10: Work-Stealing Thread Pool ===\n";
+
+    WorkStealingPool pool(4);
+    std::cout << "  Worker threads: " << pool.thread_count() << "\n";
+
+    // submit() returns a future for the callable's result
+    auto answer = pool.submit([](int a, int b) { return a * b; }, 6, 7);
+    auto greeting = pool.submit([] { return std::string("hello from the pool"); });
+    std::cout << "  submit(6 * 7): " << answer.get() << "\n";
+    std::cout << "  submit(string): " << greeting.get() << "\n";
+
+    // Exceptions travel through the future
+    auto failing = pool.submit([]() -> int { throw std::runtime_error("task failed"); });
+    try {
+        failing.get();
+    } catch (const std::exception& e) {
+        std::cout << "  Exception from task: " << e.what() << "\n";
+    }
+
+    // parallel_for over a large range, checked against the closed form
+    const size_t n = 1000000;
+    std::vector<long long> values(n);
+    auto start = std::chrono::steady_clock::now();
+    pool.parallel_for(0, n, 4096, [&values](size_t i) { values[i] = static_cast<long long>(i); });
+    auto end = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for (long long v : values) {
+        sum += v;
+    }
+    std::cout << "  parallel_for over " << n << " items correct: "
+              << (sum == static_cast<long long>(n) * (n - 1) / 2 ? "yes" : "no")
+              << " (elapsed: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << "us)\n";
+
+    // Nested parallel_for from inside pool tasks must not deadlock
+    std::atomic<int> nested_total{0};
+    std::vector<std::future<void>> outer;
+    for (int t = 0; t < 8; ++t) {
+        outer.push_back(pool.submit([&pool, &nested_total] {
+            pool.parallel_for(0, 1000, 16, [&nested_total](size_t) { nested_total.fetch_add(1); });
+        }));
+    }
+    for (auto& f : outer) {
+        f.get();
+    }
+    std::cout << "  Nested parallel_for iterations: " << nested_total.load() << " (expected 8000)\n";
+
+    try {
+        pool.parallel_for(0, 100, 10, [](size_t i) {
+            if (i == 42) {
+                throw std::runtime_error("iteration 42 failed");
+            }
+        });
+    } catch (const std::exception& e) {
+        std::cout << "  Exception from parallel_for: " << e.what() << "\n";
+    }
+    std::cout << std::endl;
+}
+
+void test_sharded_counter() {
+    std::cout << "=== Test 11: Sharded Counter ===\n";
+
+    const int num_threads = 8;
+    const int increments_per_thread = 200000;
+
+    // Same workload on the single-atomic counter and on the sharded one
+    auto run = [num_threads, increments_per_thread](auto& counter) {
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_threads; ++i) {
+            threads.emplace_back([&counter, increments_per_thread]() {
+                for (int j = 0; j < increments_per_thread; ++j) {
+                    counter.increment();
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    };
+
+    ThreadSafeCounter single;
+    ShardedCounter sharded;
+    auto single_us = run(single);
+    auto sharded_us = run(sharded);
+
+    std::cout << "  Threads: " << num_threads << ", increments per thread: " << increments_per_thread << "\n";
+    std::cout << "  ThreadSafeCounter: " << single.get() << " (" << single_us << "us)\n";
+    std::cout << "  ShardedCounter sum(): " << sharded.sum() << " (" << sharded_us << "us)\n";
+    std::cout << "  ShardedCounter get() lags by: " << (sharded.sum() - sharded.get())
+              << " (bound: " << ShardedCounter::shard_count * ShardedCounter::flush_interval << ")\n";
+
+    // 64-bit shards do not overflow past INT_MAX
+    ShardedCounter big;
+    big.increment(3000000000LL);
+    big.increment(3000000000LL);
+    std::cout << "  Large count: " << big.sum() << "\n";
+
+    big.reset();
+    std::cout << "  After reset: " << big.sum() << std::endl << std::endl;
+}
+
+void test_wait_policy_and_close() {
+    std::cout << "=== Test 12: Spin-Then-Park Waiting and close() ===\n";
+
+    // Blocked consumers exit cleanly once the queue is closed and drained
+    {
+        ThreadSafeQueue<int> queue;
+        std::atomic<int> consumed{0};
+        std::vector<std::thread> consumers;
+        for (int i = 0; i < 4; ++i) {
+            consumers.emplace_back([&queue, &consumed]() {
+                while (auto value = queue.pop()) {
+                    consumed.fetch_add(1);
+                }
+            });
+        }
+
+        for (int i = 0; i < 100; ++i) {
+            queue.push(i);
+        }
+        queue.close();
+        for (auto& t : consumers) {
+            t.join();
+        }
+
+        std::cout << "  Consumers joined after close(), consumed: " << consumed.load() << "\n";
+        std::cout << "  pop() on closed queue: " << (queue.pop().has_value() ? "item" : "empty") << "\n";
+        std::cout << "  pop_timeout() on closed queue: "
+                  << (queue.pop_timeout(std::chrono::seconds(1)).has_value() ? "item" : "empty") << "\n";
+    }
+
+    // Hand-off latency with and without a spin phase
+    auto measure = [](WaitPolicy policy) {
+        ThreadSafeQueue<std::chrono::steady_clock::time_point> queue(policy);
+        const int rounds = 2000;
+        std::vector<long long> latencies;
+        latencies.reserve(rounds);
+
+        std::thread consumer([&queue, &latencies]() {
+            while (auto sent = queue.pop()) {
+                auto now = std::chrono::steady_clock::now();
+                latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - *sent).count());
+            }
+        });
+
+        for (int i = 0; i < rounds; ++i) {
+            queue.push(std::chrono::steady_clock::now());
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        queue.close();
+        consumer.join();
+
+        std::sort(latencies.begin(), latencies.end());
+        return std::make_pair(latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100]);
+    };
+
+    auto parked = measure(WaitPolicy{});
+    auto spinning = measure(WaitPolicy{20000});
+    std::cout << "  Park only:        p50 " << parked.first / 1000.0 << "us, p99 " << parked.second / 1000.0 << "us\n";
+    std::cout << "  Spin then park:   p50 " << spinning.first / 1000.0 << "us, p99 " << spinning.second / 1000.0 << "us\n";
+    std::cout << std::endl;
+}
+
+void test_spsc_queue() {
+    std::cout << "=== Test 13: Single-Producer/Single-Consumer Queue ===\n";
+
+    // Same shape as test 1: one producer thread feeding one consumer thread
+    const int items = 1000000;
+
+    auto run_spsc = [items]() {
+        auto queue = std::make_unique<SPSCQueue<int, 1024>>();
+        long long sum = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        std::thread consumer([&queue, &sum]() {
+            while (auto value = queue->pop()) {
+                sum += value.value();
+            }
+        });
+        for (int i = 0; i < items; ++i) {
+            queue->push(i);
+        }
+        queue->close();
+        consumer.join();
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::make_pair(sum, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    };
+
+    auto run_mutex = [items]() {
+        ThreadSafeQueue<int> queue;
+        long long sum = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        std::thread consumer([&queue, &sum]() {
+            while (auto value = queue.pop()) {
+                sum += value.value();
+            }
+        });
+        for (int i = 0; i < items; ++i) {
+            queue.push(i);
+        }
+        queue.close();
+        consumer.join();
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::make_pair(sum, std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    };
+
+    const long long expected = static_cast<long long>(items) * (items - 1) / 2;
+    auto spsc = run_spsc();
+    auto locked = run_mutex();
+
+    auto ops_per_sec = [items](long long us) { return us > 0 ? items * 1000000.0 / us : 0.0; };
+    std::cout << "  Items: " << items << "\n";
+    std::cout << "  SPSCQueue:       " << spsc.second << "us (" << ops_per_sec(spsc.second) / 1e6
+              << "M ops/sec), correct: " << (spsc.first == expected ? "yes" : "no") << "\n";
+    std::cout << "  ThreadSafeQueue: " << locked.second << "us (" << ops_per_sec(locked.second) / 1e6
+              << "M ops/sec), correct: " << (locked.first == expected ? "yes" : "no") << "\n";
+
+    // Full ring rejects pushes until the consumer makes room
+    SPSCQueue<int, 2> tiny;
+    tiny.push(1);
+    tiny.push(2);
+    std::cout << "  try_push on full ring: " << (tiny.try_push(3) ? "accepted" : "rejected") << "\n";
+    std::cout << "  Popped: " << tiny.try_pop().value() << ", then try_push: "
+              << (tiny.try_push(3) ? "accepted" : "rejected") << std::endl << std::endl;
+}
+
+void test_queue_stats() {
+    std::cout << "=== Test 14: Queue Stats (Latency, Lock Wait, Wakeups) ===\n";
+
+    // Histogram buckets stay within 1/32 of the recorded value
+    bool resolution_ok = true;
+    for (uint64_t value : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, 1ull << 40, ~0ull}) {
+        uint64_t reported = LatencyHistogram::highest_equivalent(LatencyHistogram::index_of(value));
+        resolution_ok = resolution_ok && reported >= value &&
+                        reported - value <= value / LatencyHistogram::sub_buckets;
+    }
+    std::cout << "  Histogram resolution within 1/" << LatencyHistogram::sub_buckets << ": "
+              << (resolution_ok ? "yes" : "no") << "\n";
+
+    const int producers = 4;
+    const int consumers = 4;
+    const int per_producer = 25000;
+    const uint64_t total = static_cast<uint64_t>(producers) * per_producer;
+
+    ThreadSafeQueue<int, QueueStats> queue;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue]() {
+            for (int i = 0; i < per_producer; ++i) {
+                queue.push(i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&queue]() {
+            while (queue.pop()) {
+            }
+        });
+    }
+    for (int p = 0; p < producers; ++p) {
+        threads[p].join();
+    }
+    queue.close();
+    for (size_t c = producers; c < threads.size(); ++c) {
+        threads[c].join();
+    }
+
+    QueueStatsSnapshot s = queue.stats();
+    uint64_t p50 = s.latency.percentile(0.5);
+    uint64_t p99 = s.latency.percentile(0.99);
+    std::cout << "  Pushed: " << s.pushed << ", popped: " << s.popped << ", latency samples: " << s.latency.total
+              << " (all " << total << ": " << (s.pushed == total && s.popped == total && s.latency.total == total ? "yes" : "no")
+              << ")\n";
+    std::cout << "  Percentiles ordered (p50 <= p99 <= max): "
+              << (p50 <= p99 && p99 <= s.latency.max ? "yes" : "no") << "\n";
+    std::cout << "  Latency p50 " << p50 / 1000.0 << "us, p99 " << p99 / 1000.0 << "us, max " << s.latency.max / 1000.0
+              << "us\n";
+    std::cout << "  Depth high-water: " << s.depth_high_water << "\n";
+    std::cout << "  Lock: " << s.lock_contended << " of " << s.lock_acquisitions << " acquisitions waited, "
+              << s.lock_wait.count() / 1000 << "us total, " << s.lock_wait_max.count() / 1000.0 << "us max\n";
+    std::cout << "  Wakeups: " << s.wakeups << " (" << s.spurious_wakeups << " found nothing)\n";
+    std::cout << "  Throughput: " << s.push_rate() / 1e6 << "M pushes/sec, " << s.pop_rate() / 1e6
+              << "M pops/sec\n";
+
+    // A notify with nothing queued wakes the consumer for nothing
+    ThreadSafeQueue<int, QueueStats> idle;
+    std::thread waiter([&idle]() { idle.pop(); });
+    while (idle.stats().spurious_wakeups == 0) {
+        idle.notify_all();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    idle.push(1);
+    waiter.join();
+    std::cout << "  Empty notify counted as spurious: " << (idle.stats().spurious_wakeups >= 1 ? "yes" : "no") << "\n";
+
+    // Scrapable text form
+    std::vector<int> batch(10, 7);
+    idle.push_bulk(batch.begin(), batch.end());
+    std::cout << "  Metrics after a bulk push of " << batch.size() << ":\n";
+    std::ostringstream metrics;
+    write_metrics(metrics, idle.stats(), "idle_queue");
+    std::istringstream lines(metrics.str());
+    for (std::string line; std::getline(lines, line);) {
+        if (line.find("_pushed_") != std::string::npos || line.find("_popped_") != std::string::npos ||
+            line.find("high_water") != std::string::npos) {
+            std::cout << "    " << line << "\n";
+        }
+    }
+
+    std::cout << "  sizeof(ThreadSafeQueue<int>): " << sizeof(ThreadSafeQueue<int>)
+              << " bytes, with QueueStats: " << sizeof(ThreadSafeQueue<int, QueueStats>) << " bytes\n";
+    std::cout << std::endl;
+}
+
+void test_priority_deadline_queue() {
+    std::cout << "=== Test 15: Priority and Deadline Scheduling ===\n";
+    using Job = Scheduled<std::string>;
+    auto now = Job::clock::now();
+
+    // Higher priority first, earlier deadline breaks ties, then FIFO
+    {
+        ThreadSafeQueue<Job, NoQueueStats, PriorityOrder<>> queue;
+        queue.push({"bulk-1", 0});
+        queue.push({"urgent-late", 5, now + std::chrono::seconds(2)});
+        queue.push({"normal", 1});
+        queue.push({"urgent-soon", 5, now + std::chrono::seconds(1)});
+        queue.push({"bulk-2", 0});
+
+        std::cout << "  Pop order:";
+        while (auto job = queue.try_pop()) {
+            std::cout << " " << job->value;
+        }
+        std::cout << "\n";
+    }
+
+    // The heap pops any ordering correctly (here smallest first)
+    {
+        ThreadSafeQueue<int, NoQueueStats, PriorityOrder<4, std::less<>>> queue;
+        std::vector<int> values;
+        uint32_t state = 12345;
+        for (int i = 0; i < 10000; ++i) {
+            state = state * 1664525u + 1013904223u;
+            values.push_back(static_cast<int>(state >> 16) % 1000);
+        }
+        queue.push_bulk(values.cbegin(), values.cend());
+
+        std::vector<int> popped;
+        queue.try_pop_bulk(std::back_inserter(popped), values.size());
+        std::sort(values.begin(), values.end());
+        std::cout << "  4-ary heap pops " << popped.size() << " values in sorted order: "
+                  << (popped == values ? "yes" : "no") << "\n";
+    }
+
+    // Latency-critical work overtakes a backlog of bulk work
+    {
+        ThreadSafeQueue<Job, NoQueueStats, PriorityOrder<>> queue;
+        for (int i = 0; i < 10000; ++i) {
+            queue.push({"bulk", 0});
+        }
+        queue.push({"request", 10});
+        std::cout << "  First pop behind 10000 bulk items: " << queue.pop()->value << "\n";
+    }
+
+    // Stale work is shed, never handed to a consumer
+    {
+        ThreadSafeQueue<Job, QueueStats, PriorityOrder<>> queue;
+        auto past = Job::clock::now() - std::chrono::milliseconds(1);
+        queue.push({"stale-high", 9, past});
+        queue.push({"stale-low", 1, past});
+        queue.push({"live", 5});
+        queue.push({"stale-mid", 5, past});
+
+        auto first = queue.pop_expired_drop(std::chrono::milliseconds(10));
+        auto second = queue.pop_expired_drop(std::chrono::milliseconds(10));
+        std::cout << "  pop_expired_drop: " << (first ? first->value : "empty") << ", then "
+                  << (second ? second->value : "empty") << " (timed out after shedding the rest)\n";
+        std::cout << "  Expired items dropped: " << queue.stats().expired_dropped << ", popped: "
+                  << queue.stats().popped << "\n";
+
+        // A live item arriving during the wait is still delivered
+        std::thread producer([&queue]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            queue.push({"late-arrival", 0, Job::clock::now() + std::chrono::seconds(1)});
+        });
+        auto arrived = queue.pop_expired_drop(std::chrono::seconds(5));
+        producer.join();
+        std::cout << "  Waiting pop_expired_drop got: " << (arrived ? arrived->value : "empty") << "\n";
+
+        queue.close();
+        auto start = std::chrono::steady_clock::now();
+        bool empty = !queue.pop_expired_drop(std::chrono::seconds(5)).has_value();
+        bool prompt = std::chrono::steady_clock::now() - start < std::chrono::seconds(1);
+        std::cout << "  Closed queue returns empty at once: " << (empty && prompt ? "yes" : "no") << "\n";
+    }
+
+    // FIFO order can shed too: only stale items at the front are dropped
+    {
+        ThreadSafeQueue<Job> queue;
+        queue.push({"stale", 0, now - std::chrono::seconds(1)});
+        queue.push({"fresh", 0});
+        std::cout << "  FIFO pop_expired_drop: " << queue.pop_expired_drop(std::chrono::milliseconds(10))->value
+                  << "\n";
+    }
+    std::cout << std::endl;
+}
+
+// Returns false if a hot path copied an item or allocated
+bool test_hot_path_tracking() {
+    std::cout << "=== Test 16: Copy-Free, Allocation-Free Hot Paths ===\n";
+    using Payload = tracking::Tracked<std::string>;
+    const size_t rounds = 256;
+    bool clean = true;
+
+    auto report = [&clean](const char* path, const tracking::Counts& counts, uint64_t max_allocations) {
+        bool ok = counts.copies() == 0 && counts.allocations() <= max_allocations;
+        clean = clean && ok;
+        std::cout << "  " << path << ": " << counts.copies() << " copies, " << counts.moves() << " moves, "
+                  << counts.allocations() << " allocations (at most " << max_allocations << ")"
+                  << (ok ? "" : "  FAIL") << "\n";
+    };
+
+    // Payloads are built (and their strings allocated) before the scopes open
+    auto make_payloads = [rounds]() {
+        std::vector<Payload> payloads;
+        payloads.reserve(rounds);
+        for (size_t i = 0; i < rounds; ++i) {
+            payloads.emplace_back(std::string(48, static_cast<char>('a' + i % 26)));
+        }
+        return payloads;
+    };
+
+    // std::deque storage takes a new node each time the back crosses a 512-byte
+    // node boundary, so the bound is one allocation per node's worth of items
+    {
+        ThreadSafeQueue<Payload> queue;
+        std::vector<Payload> payloads = make_payloads();
+        const uint64_t per_node = std::max<uint64_t>(1, 512 / sizeof(Payload));
+        tracking::Scope scope(TRACKING_SITE("ThreadSafeQueue push/pop"));
+        for (Payload& payload : payloads) {
+            queue.push(std::move(payload));
+            std::optional<Payload> item = queue.pop();
+            payload = std::move(*item);
+        }
+        report("ThreadSafeQueue push(T&&) + pop()", scope.counts(), rounds / per_node + 1);
+    }
+    {
+        BoundedMPMCQueue<Payload, 64> queue;
+        std::vector<Payload> payloads = make_payloads();
+        tracking::Scope scope(TRACKING_SITE("BoundedMPMCQueue push/pop"));
+        for (Payload& payload : payloads) {
+            queue.push(std::move(payload));
+            payload = std::move(*queue.try_pop());
+        }
+        report("BoundedMPMCQueue push(T&&) + try_pop()", scope.counts(), 0);
+    }
+    {
+        auto queue = std::make_unique<SPSCQueue<Payload, 64>>();
+        std::vector<Payload> payloads = make_payloads();
+        tracking::Scope scope(TRACKING_SITE("SPSCQueue push/pop"));
+        for (Payload& payload : payloads) {
+            queue->push(std::move(payload));
+            payload = std::move(*queue->try_pop());
+        }
+        report("SPSCQueue push(T&&) + try_pop()", scope.counts(), 0);
+    }
+
+    std::cout << "  Every path within its bounds: " << (clean ? "yes" : "no") << "\n" << std::endl;
+    return clean;
+}
+
 int main() {
     std::cout << "=== Exercise 3: Thread-Safe Data Structure ===\n\n";
 
@@ -355,8 +2437,19 @@ int main() {
     test_timeout();
     test_move_semantics();
     test_concurrent_stress();
+    test_bounded_mpmc_queue();
+    test_bounded_mpmc_stress();
+    test_bulk_operations();
+    test_work_stealing_pool();
+    test_sharded_counter();
+    test_wait_policy_and_close();
+    test_spsc_queue();
+    test_queue_stats();
+    test_priority_deadline_queue();
+    bool hot_paths_clean = test_hot_path_tracking();
 
     std::cout << "All tests completed!\n";
-    return 0;
+    return hot_paths_clean ? 0 : 1;
 }
 
+#endif  // EXERCISE_3_NO_MAIN
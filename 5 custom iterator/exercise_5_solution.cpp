@@ -4,6 +4,442 @@
 #include <numeric>
 #include <iterator>
 #include <type_traits>
+#include <initializer_list>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <optional>
+#include <functional>
+
+#include "../common/tracking.h"
+
+// The parallel algorithms below run on exercise 3's work-stealing pool
+#define EXERCISE_3_NO_MAIN
+#include "../3 thread safe data structure/exercise_3_solution.cpp"
+
+// ============================================================================
+// SIMD Kernels for Arithmetic Element Types
+// ============================================================================
+
+// Bulk kernels behind FixedArray's sum/min/max/dot/count/find/transform_inplace.
+// Each kernel is written once against a GCC/Clang vector type of Width bytes
+// and stamped out per instruction set; the widest set the CPU supports is
+// picked once at runtime. SSE2 and NEON are the 16-byte baseline on x86-64
+// and AArch64. Compilers without vector extensions get the scalar loops.
+namespace simd {
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FIXED_ARRAY_VECTOR_EXTENSIONS 1
+#endif
+
+#if defined(FIXED_ARRAY_VECTOR_EXTENSIONS) && (defined(__x86_64__) || defined(__i386__))
+#define FIXED_ARRAY_X86_DISPATCH 1
+#endif
+
+enum class Isa { Scalar, Baseline, AVX2, AVX512 };
+
+inline Isa detect_isa() {
+#ifdef FIXED_ARRAY_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return Isa::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return Isa::AVX2;
+    }
+    return Isa::Baseline;
+#elif defined(FIXED_ARRAY_VECTOR_EXTENSIONS)
+    return Isa::Baseline;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+// Detected once; the per-call cost of dispatch is one load and a switch
+inline Isa active_isa() {
+    static const Isa isa = detect_isa();
+    return isa;
+}
+
+inline const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::AVX512: return "AVX-512";
+        case Isa::AVX2: return "AVX2";
+        case Isa::Baseline: return "SSE2/NEON";
+        default: return "scalar";
+    }
+}
+
+// Element types the kernels accept (bool has no meaningful vector arithmetic)
+template<typename T>
+constexpr bool is_simd_arithmetic_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+// Opts a callable into transform_inplace's full-width path: the wrapped f
+// is called on vector types, so its body must be plain arithmetic that
+// vector extensions support. Unwrapped callables always run elementwise,
+// which keeps e.g. [](auto x) { return std::sqrt(x); } from ever being
+// instantiated with a vector (deducing its return type would be a hard
+// error, not a fallback).
+template<typename F>
+struct vectorized_fn {
+    F fn;
+
+    template<typename X>
+    auto operator()(X x) const -> decltype(fn(x)) {
+        return fn(x);
+    }
+};
+
+template<typename F>
+vectorized_fn<F> vectorized(F fn) {
+    return vectorized_fn<F>{std::move(fn)};
+}
+
+template<typename F>
+struct is_vectorized : std::false_type {};
+
+template<typename F>
+struct is_vectorized<vectorized_fn<F>> : std::true_type {};
+
+template<typename F>
+constexpr bool is_vectorized_v = is_vectorized<std::remove_cv_t<F>>::value;
+
+// Scalar reference kernels: the fallback, and the tail of every vector loop
+struct scalar {
+    template<typename T>
+    static T sum(const T* p, size_t n) {
+        T total{};
+        for (size_t i = 0; i < n; ++i) {
+            total += p[i];
+        }
+        return total;
+    }
+
+    template<typename T>
+    static T min(const T* p, size_t n) {
+        T best = p[0];
+        for (size_t i = 1; i < n; ++i) {
+            best = p[i] < best ? p[i] : best;
+        }
+        return best;
+    }
+
+    template<typename T>
+    static T max(const T* p, size_t n) {
+        T best = p[0];
+        for (size_t i = 1; i < n; ++i) {
+            best = p[i] > best ? p[i] : best;
+        }
+        return best;
+    }
+
+    template<typename T>
+    static T dot(const T* a, const T* b, size_t n) {
+        T total{};
+        for (size_t i = 0; i < n; ++i) {
+            total += a[i] * b[i];
+        }
+        return total;
+    }
+
+    template<typename T>
+    static size_t count(const T* p, size_t n, T value) {
+        size_t matches = 0;
+        for (size_t i = 0; i < n; ++i) {
+            matches += p[i] == value;
+        }
+        return matches;
+    }
+
+    template<typename T>
+    static size_t find(const T* p, size_t n, T value) {
+        for (size_t i = 0; i < n; ++i) {
+            if (p[i] == value) {
+                return i;
+            }
+        }
+        return n;
+    }
+
+    template<typename T, typename F>
+    static void transform(T* p, size_t n, F& f) {
+        for (size_t i = 0; i < n; ++i) {
+            p[i] = f(p[i]);
+        }
+    }
+
+};
+
+#ifdef FIXED_ARRAY_VECTOR_EXTENSIONS
+
+// load() returns wide vectors but is always inlined, so the ABI note GCC
+// attaches to such signatures never applies
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+template<typename T, size_t Width>
+struct vector_of {
+    typedef T type __attribute__((vector_size(Width)));
+};
+
+template<typename T, size_t Width>
+using vec_t = typename vector_of<T, Width>::type;
+
+// Forced inline so each kernel is compiled with its caller's target ISA; a
+// real call would also pass wide vectors under the caller-incompatible ABI
+#define FIXED_ARRAY_SIMD_INLINE __attribute__((always_inline)) inline
+
+// Integer lanes are summed and multiplied unsigned so wraparound is defined
+template<typename T, bool = std::is_integral_v<T>>
+struct accumulate_type {
+    using type = T;
+};
+
+template<typename T>
+struct accumulate_type<T, true> {
+    using type = std::make_unsigned_t<T>;
+};
+
+template<typename T>
+using accumulate_t = typename accumulate_type<T>::type;
+
+// Unaligned load/store; compiles to a single vector move
+template<typename V, typename T>
+FIXED_ARRAY_SIMD_INLINE V load(const T* p) {
+    V v;
+    std::memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+template<typename V, typename T>
+FIXED_ARRAY_SIMD_INLINE void store(T* p, const V& v) {
+    std::memcpy(p, &v, sizeof(V));
+}
+
+// Generic kernels. Four independent accumulators hide add latency; lanes are
+// folded and the remainder handled by the scalar kernel at the end.
+template<size_t Width>
+struct kernels {
+    template<typename T>
+    static constexpr size_t lanes = Width / sizeof(T);
+
+    template<typename T>
+    FIXED_ARRAY_SIMD_INLINE static T sum(const T* data, size_t n) {
+        using A = accumulate_t<T>;
+        using V = vec_t<A, Width>;
+        constexpr size_t L = lanes<T>;
+        const A* p = reinterpret_cast<const A*>(data);
+        V acc0{}, acc1{}, acc2{}, acc3{};
+        size_t i = 0;
+        for (; i + 4 * L <= n; i += 4 * L) {
+            acc0 += load<V>(p + i);
+            acc1 += load<V>(p + i + L);
+            acc2 += load<V>(p + i + 2 * L);
+            acc3 += load<V>(p + i + 3 * L);
+        }
+        for (; i + L <= n; i += L) {
+            acc0 += load<V>(p + i);
+        }
+        V acc = (acc0 + acc1) + (acc2 + acc3);
+        A total{};
+        for (size_t lane = 0; lane < L; ++lane) {
+            total += acc[lane];
+        }
+        return static_cast<T>(total + scalar::sum(p + i, n - i));
+    }
+
+    template<typename T>
+    FIXED_ARRAY_SIMD_INLINE static T min(const T* p, size_t n) {
+        using V = vec_t<T, Width>;
+        constexpr size_t L = lanes<T>;
+        if (n < L) {
+            return scalar::min(p, n);
+        }
+        V best = load<V>(p);
+        size_t i = L;
+        for (; i + L <= n; i += L) {
+            V v = load<V>(p + i);
+            best = v < best ? v : best;
+        }
+        T result = best[0];
+        for (size_t lane = 1; lane < L; ++lane) {
+            result = best[lane] < result ? best[lane] : result;
+        }
+        return i < n ? std::min(result, scalar::min(p + i, n - i)) : result;
+    }
+
+    template<typename T>
+    FIXED_ARRAY_SIMD_INLINE static T max(const T* p, size_t n) {
+        using V = vec_t<T, Width>;
+        constexpr size_t L = lanes<T>;
+        if (n < L) {
+            return scalar::max(p, n);
+        }
+        V best = load<V>(p);
+        size_t i = L;
+        for (; i + L <= n; i += L) {
+            V v = load<V>(p + i);
+            best = v > best ? v : best;
+        }
+        T result = best[0];
+        for (size_t lane = 1; lane < L; ++lane) {
+            result = best[lane] > result ? best[lane] : result;
+        }
+        return i < n ? std::max(result, scalar::max(p + i, n - i)) : result;
+    }
+
+    template<typename T>
+    FIXED_ARRAY_SIMD_INLINE static T dot(const T* lhs, const T* rhs, size_t n) {
+        using A = accumulate_t<T>;
+        using V = vec_t<A, Width>;
+        constexpr size_t L = lanes<T>;
+        const A* a = reinterpret_cast<const A*>(lhs);
+        const A* b = reinterpret_cast<const A*>(rhs);
+        V acc0{}, acc1{};
+        size_t i = 0;
+        for (; i + 2 * L <= n; i += 2 * L) {
+            acc0 += load<V>(a + i) * load<V>(b + i);
+            acc1 += load<V>(a + i + L) * load<V>(b + i + L);
+        }
+        for (; i + L <= n; i += L) {
+            acc0 += load<V>(a + i) * load<V>(b + i);
+        }
+        V acc = acc0 + acc1;
+        A total{};
+        for (size_t lane = 0; lane < L; ++lane) {
+            total += acc[lane];
+        }
+        return static_cast<T>(total + scalar::dot(a + i, b + i, n - i));
+    }
+
+    template<typename T>
+    FIXED_ARRAY_SIMD_INLINE static size_t count(const T* p, size_t n, T value) {
+        using V = vec_t<T, Width>;
+        using M = decltype(V{} == V{});  // Lanes are 0 or -1
+        constexpr size_t L = lanes<T>;
+        // Narrow mask lanes would overflow, so fold them into size_t regularly
+        constexpr size_t flush_every = sizeof(T) >= 4 ? SIZE_MAX : (size_t(1) << (8 * sizeof(T) - 1)) - 1;
+        const V needle = V{} + value;
+        size_t matches = 0;
+        size_t i = 0;
+        while (i + L <= n) {
+            M hits{};
+            for (size_t block = 0; block < flush_every && i + L <= n; ++block, i += L) {
+                hits -= (load<V>(p + i) == needle);
+            }
+            for (size_t lane = 0; lane < L; ++lane) {
+                matches += static_cast<size_t>(hits[lane]);
+            }
+        }
+        return matches + scalar::count(p + i, n - i, value);
+    }
+
+    template<typename T>
+    FIXED_ARRAY_SIMD_INLINE static size_t find(const T* p, size_t n, T value) {
+        using V = vec_t<T, Width>;
+        using Words = vec_t<uint64_t, Width>;
+        constexpr size_t L = lanes<T>;
+        const V needle = V{} + value;
+        size_t i = 0;
+        for (; i + L <= n; i += L) {
+            Words hit = reinterpret_cast<Words>(load<V>(p + i) == needle);
+            uint64_t any = 0;
+            for (size_t word = 0; word < Width / 8; ++word) {
+                any |= hit[word];
+            }
+            if (any) {
+                return i + scalar::find(p + i, L, value);
+            }
+        }
+        return i + scalar::find(p + i, n - i, value);
+    }
+
+    // A callable wrapped with simd::vectorized is fed 16-byte vectors: f is
+    // compiled for the baseline ISA, and only 16-byte vectors share a calling
+    // convention with it. Any other callable runs the elementwise loop.
+    template<typename T, typename F>
+    FIXED_ARRAY_SIMD_INLINE static void transform(T* p, size_t n, F& f) {
+        using V = vec_t<T, 16>;
+        constexpr size_t L = 16 / sizeof(T);
+        size_t i = 0;
+        if constexpr (is_vectorized_v<F>) {
+            static_assert(std::is_invocable_r_v<V, F&, V>,
+                          "simd::vectorized callable must accept and return the element vector type");
+            for (; i + L <= n; i += L) {
+                store(p + i, static_cast<V>(f(load<V>(p + i))));
+            }
+        }
+        scalar::transform(p + i, n - i, f);
+    }
+};
+
+#ifdef FIXED_ARRAY_X86_DISPATCH
+#define FIXED_ARRAY_SIMD_TARGET(name, isa, width)                                          \
+    struct name {                                                                          \
+        template<typename T>                                                               \
+        __attribute__((target(isa))) static T sum(const T* p, size_t n) {                  \
+            return kernels<width>::sum(p, n);                                              \
+        }                                                                                  \
+        template<typename T>                                                               \
+        __attribute__((target(isa))) static T min(const T* p, size_t n) {                  \
+            return kernels<width>::min(p, n);                                              \
+        }                                                                                  \
+        template<typename T>                                                               \
+        __attribute__((target(isa))) static T max(const T* p, size_t n) {                  \
+            return kernels<width>::max(p, n);                                              \
+        }                                                                                  \
+        template<typename T>                                                               \
+        __attribute__((target(isa))) static T dot(const T* a, const T* b, size_t n) {      \
+            return kernels<width>::dot(a, b, n);                                           \
+        }                                                                                  \
+        template<typename T>                                                               \
+        __attribute__((target(isa))) static size_t count(const T* p, size_t n, T v) {      \
+            return kernels<width>::count(p, n, v);                                         \
+        }                                                                                  \
+        template<typename T>                                                               \
+        __attribute__((target(isa))) static size_t find(const T* p, size_t n, T v) {       \
+            return kernels<width>::find(p, n, v);                                          \
+        }                                                                                  \
+        template<typename T, typename F>                                                   \
+        __attribute__((target(isa))) static void transform(T* p, size_t n, F& f) {         \
+            kernels<width>::transform(p, n, f);                                            \
+        }                                                                                  \
+    };
+
+FIXED_ARRAY_SIMD_TARGET(avx2, "avx2", 32)
+FIXED_ARRAY_SIMD_TARGET(avx512, "avx512f,avx512bw", 64)
+
+#undef FIXED_ARRAY_SIMD_TARGET
+#endif  // FIXED_ARRAY_X86_DISPATCH
+
+#pragma GCC diagnostic pop
+
+using baseline = kernels<16>;
+
+// Calls op with the kernel set for the active instruction set
+template<typename Op>
+decltype(auto) dispatch(Op&& op) {
+    switch (active_isa()) {
+#ifdef FIXED_ARRAY_X86_DISPATCH
+        case Isa::AVX512: return op(avx512{});
+        case Isa::AVX2: return op(avx2{});
+#endif
+        default: return op(baseline{});
+    }
+}
+
+#else  // !FIXED_ARRAY_VECTOR_EXTENSIONS
+
+template<typename Op>
+decltype(auto) dispatch(Op&& op) {
+    return op(scalar{});
+}
+
+#endif  // FIXED_ARRAY_VECTOR_EXTENSIONS
+
+}  // namespace simd
 
 // ============================================================================
 // Custom Fixed-Size Array Container with Random Access Iterator
@@ -12,7 +448,10 @@
 template<typename T, size_t N>
 class FixedArray {
 private:
-    T data_[N];
+    // Cache-line aligned so vector kernels start on a full-width boundary
+    static constexpr size_t storage_alignment = std::max(alignof(T), size_t(64));
+
+    alignas(storage_alignment) T data_[N];
 
 public:
     // Iterator class (nested)
@@ -21,90 +460,101 @@ public:
         T* ptr_;
 
     public:
-        // Iterator traits (C++17 approach)
+        // Iterator traits (C++17 approach); iterator_concept and element_type
+        // let C++20 treat it as a contiguous iterator (std::to_address, ranges)
         using iterator_category = std::random_access_iterator_tag;
+#ifdef __cpp_lib_ranges
+        using iterator_concept = std::contiguous_iterator_tag;
+#endif
         using value_type = T;
+        using element_type = T;
         using difference_type = std::ptrdiff_t;
         using pointer = T*;
         using reference = T&;
 
-        // Constructor
-        explicit iterator(T* ptr) : ptr_(ptr) {}
+        // Constructors
+        constexpr iterator() noexcept : ptr_(nullptr) {}
+        explicit constexpr iterator(T* ptr) noexcept : ptr_(ptr) {}
 
         // Dereference operators
-        reference operator*() const { return *ptr_; }
-        pointer operator->() const { return ptr_; }
-        reference operator[](difference_type n) const { return ptr_[n]; }
+        constexpr reference operator*() const noexcept { return *ptr_; }
+        constexpr pointer operator->() const noexcept { return ptr_; }
+        constexpr reference operator[](difference_type n) const noexcept { return ptr_[n]; }
 
         // Increment operators
-        iterator& operator++() {
+        constexpr iterator& operator++() noexcept {
             ++ptr_;
             return *this;
         }
 
-        iterator operator++(int) {
+        constexpr iterator operator++(int) noexcept {
             iterator temp = *this;
             ++ptr_;
             return temp;
         }
 
         // Decrement operators
-        iterator& operator--() {
+        constexpr iterator& operator--() noexcept {
             --ptr_;
             return *this;
         }
 
-        iterator operator--(int) {
+        constexpr iterator operator--(int) noexcept {
             iterator temp = *this;
             --ptr_;
             return temp;
         }
 
         // Arithmetic operators
-        iterator& operator+=(difference_type n) {
+        constexpr iterator& operator+=(difference_type n) noexcept {
             ptr_ += n;
             return *this;
         }
 
-        iterator& operator-=(difference_type n) {
+        constexpr iterator& operator-=(difference_type n) noexcept {
             ptr_ -= n;
             return *this;
         }
 
-        iterator operator+(difference_type n) const {
+        constexpr iterator operator+(difference_type n) const noexcept {
             return iterator(ptr_ + n);
         }
 
-        iterator operator-(difference_type n) const {
+        constexpr iterator operator-(difference_type n) const noexcept {
             return iterator(ptr_ - n);
         }
 
-        difference_type operator-(const iterator& other) const {
+        // n + it, found by argument-dependent lookup
+        friend constexpr iterator operator+(difference_type n, const iterator& it) noexcept {
+            return it + n;
+        }
+
+        constexpr difference_type operator-(const iterator& other) const noexcept {
             return ptr_ - other.ptr_;
         }
 
         // Comparison operators
-        bool operator==(const iterator& other) const {
+        constexpr bool operator==(const iterator& other) const noexcept {
             return ptr_ == other.ptr_;
         }
 
-        bool operator!=(const iterator& other) const {
+        constexpr bool operator!=(const iterator& other) const noexcept {
             return ptr_ != other.ptr_;
         }
 
-        bool operator<(const iterator& other) const {
+        constexpr bool operator<(const iterator& other) const noexcept {
             return ptr_ < other.ptr_;
         }
 
-        bool operator>(const iterator& other) const {
+        constexpr bool operator>(const iterator& other) const noexcept {
             return ptr_ > other.ptr_;
         }
 
-        bool operator<=(const iterator& other) const {
+        constexpr bool operator<=(const iterator& other) const noexcept {
             return ptr_ <= other.ptr_;
         }
 
-        bool operator>=(const iterator& other) const {
+        constexpr bool operator>=(const iterator& other) const noexcept {
             return ptr_ >= other.ptr_;
         }
     };
@@ -116,82 +566,101 @@ public:
 
     public:
         using iterator_category = std::random_access_iterator_tag;
-        using value_type = const T;
+#ifdef __cpp_lib_ranges
+        using iterator_concept = std::contiguous_iterator_tag;
+#endif
+        using value_type = T;
+        using element_type = const T;
         using difference_type = std::ptrdiff_t;
         using pointer = const T*;
         using reference = const T&;
 
-        explicit const_iterator(const T* ptr) : ptr_(ptr) {}
+        // Constructors
+        constexpr const_iterator() noexcept : ptr_(nullptr) {}
+        explicit constexpr const_iterator(const T* ptr) noexcept : ptr_(ptr) {}
+
+        // Every iterator converts to a const_iterator
+        constexpr const_iterator(const iterator& it) noexcept : ptr_(it.operator->()) {}
 
-        reference operator*() const { return *ptr_; }
-        pointer operator->() const { return ptr_; }
-        reference operator[](difference_type n) const { return ptr_[n]; }
+        // Dereference operators
+        constexpr reference operator*() const noexcept { return *ptr_; }
+        constexpr pointer operator->() const noexcept { return ptr_; }
+        constexpr reference operator[](difference_type n) const noexcept { return ptr_[n]; }
 
-        const_iterator& operator++() {
+        // Increment operators
+        constexpr const_iterator& operator++() noexcept {
             ++ptr_;
             return *this;
         }
 
-        const_iterator operator++(int) {
+        constexpr const_iterator operator++(int) noexcept {
             const_iterator temp = *this;
             ++ptr_;
             return temp;
         }
 
-        const_iterator& operator--() {
+        // Decrement operators
+        constexpr const_iterator& operator--() noexcept {
             --ptr_;
             return *this;
         }
 
-        const_iterator operator--(int) {
+        constexpr const_iterator operator--(int) noexcept {
             const_iterator temp = *this;
             --ptr_;
             return temp;
         }
 
-        const_iterator& operator+=(difference_type n) {
+        // Arithmetic operators
+        constexpr const_iterator& operator+=(difference_type n) noexcept {
             ptr_ += n;
             return *this;
         }
 
-        const_iterator& operator-=(difference_type n) {
+        constexpr const_iterator& operator-=(difference_type n) noexcept {
             ptr_ -= n;
             return *this;
         }
 
-        const_iterator operator+(difference_type n) const {
+        constexpr const_iterator operator+(difference_type n) const noexcept {
             return const_iterator(ptr_ + n);
         }
 
-        const_iterator operator-(difference_type n) const {
+        constexpr const_iterator operator-(difference_type n) const noexcept {
             return const_iterator(ptr_ - n);
         }
 
-        difference_type operator-(const const_iterator& other) const {
+        // n + it, found by argument-dependent lookup
+        friend constexpr const_iterator operator+(difference_type n, const const_iterator& it) noexcept {
+            return it + n;
+        }
+
+        constexpr difference_type operator-(const const_iterator& other) const noexcept {
             return ptr_ - other.ptr_;
         }
 
-        bool operator==(const const_iterator& other) const {
+        // Comparison operators
+        constexpr bool operator==(const const_iterator& other) const noexcept {
             return ptr_ == other.ptr_;
         }
 
-        bool operator!=(const const_iterator& other) const {
+        constexpr bool operator!=(const const_iterator& other) const noexcept {
             return ptr_ != other.ptr_;
         }
 
-        bool operator<(const const_iterator& other) const {
+        constexpr bool operator<(const const_iterator& other) const noexcept {
             return ptr_ < other.ptr_;
         }
 
-        bool operator>(const const_iterator& other) const {
+        constexpr bool operator>(const const_iterator& other) const noexcept {
             return ptr_ > other.ptr_;
         }
 
-        bool operator<=(const const_iterator& other) const {
+        constexpr bool operator<=(const const_iterator& other) const noexcept {
             return ptr_ <= other.ptr_;
         }
 
-        bool operator>=(const const_iterator& other) const {
+        constexpr bool operator>=(const const_iterator& other) const noexcept {
             return ptr_ >= other.ptr_;
         }
     };
@@ -205,12 +674,10 @@ public:
     using pointer = T*;
     using const_pointer = const T*;
 
-    // Constructors
-    FixedArray() {
-        std::fill(data_, data_ + N, T{});
-    }
+    // Constructors (constexpr, so literal-type tables can be built at compile time)
+    constexpr FixedArray() : data_{} {}
 
-    FixedArray(std::initializer_list<T> init) {
+    constexpr FixedArray(std::initializer_list<T> init) : data_{} {
         size_t i = 0;
         for (const auto& val : init) {
             if (i < N) {
@@ -226,17 +693,17 @@ public:
     }
 
     // Accessors
-    reference operator[](size_type index) { return data_[index]; }
-    const_reference operator[](size_type index) const { return data_[index]; }
+    constexpr reference operator[](size_type index) noexcept { return data_[index]; }
+    constexpr const_reference operator[](size_type index) const noexcept { return data_[index]; }
     
-    reference at(size_type index) {
+    constexpr reference at(size_type index) {
         if (index >= N) {
             throw std::out_of_range("FixedArray::at: index out of range");
         }
         return data_[index];
     }
 
-    const_reference at(size_type index) const {
+    constexpr const_reference at(size_type index) const {
         if (index >= N) {
             throw std::out_of_range("FixedArray::at: index out of range");
         }
@@ -244,39 +711,507 @@ public:
     }
 
     // Iterators
-    iterator begin() { return iterator(data_); }
-    iterator end() { return iterator(data_ + N); }
-    const_iterator begin() const { return const_iterator(data_); }
-    const_iterator end() const { return const_iterator(data_ + N); }
-    const_iterator cbegin() const { return const_iterator(data_); }
-    const_iterator cend() const { return const_iterator(data_ + N); }
+    constexpr iterator begin() noexcept { return iterator(data_); }
+    constexpr iterator end() noexcept { return iterator(data_ + N); }
+    constexpr const_iterator begin() const noexcept { return const_iterator(data_); }
+    constexpr const_iterator end() const noexcept { return const_iterator(data_ + N); }
+    constexpr const_iterator cbegin() const noexcept { return const_iterator(data_); }
+    constexpr const_iterator cend() const noexcept { return const_iterator(data_ + N); }
 
     // Capacity
-    constexpr size_type size() const { return N; }
-    constexpr bool empty() const { return N == 0; }
-    constexpr size_type max_size() const { return N; }
+    constexpr size_type size() const noexcept { return N; }
+    constexpr bool empty() const noexcept { return N == 0; }
+    constexpr size_type max_size() const noexcept { return N; }
+
+    // Raw storage (aligned to at least 64 bytes)
+    constexpr pointer data() noexcept { return data_; }
+    constexpr const_pointer data() const noexcept { return data_; }
+
+    // Operations (a plain loop: std::fill is not constexpr until C++20)
+    constexpr void fill(const T& value) {
+        for (size_type i = 0; i < N; ++i) {
+            data_[i] = value;
+        }
+    }
+
+    // Vectorized bulk operations for arithmetic T, dispatched at runtime to the
+    // widest supported instruction set. Floating-point sums and dot products
+    // are reassociated across lanes, so they may differ from a sequential
+    // std::accumulate in the last bits.
+    T sum() const {
+        static_assert(simd::is_simd_arithmetic_v<T>, "FixedArray::sum requires an arithmetic element type");
+        return simd::dispatch([this](auto kernels) { return kernels.sum(data_, N); });
+    }
+
+    T min() const {
+        static_assert(simd::is_simd_arithmetic_v<T>, "FixedArray::min requires an arithmetic element type");
+        return simd::dispatch([this](auto kernels) { return kernels.min(data_, N); });
+    }
+
+    T max() const {
+        static_assert(simd::is_simd_arithmetic_v<T>, "FixedArray::max requires an arithmetic element type");
+        return simd::dispatch([this](auto kernels) { return kernels.max(data_, N); });
+    }
+
+    T dot(const FixedArray& other) const {
+        static_assert(simd::is_simd_arithmetic_v<T>, "FixedArray::dot requires an arithmetic element type");
+        return simd::dispatch([&](auto kernels) { return kernels.dot(data_, other.data_, N); });
+    }
+
+    size_type count(const T& value) const {
+        static_assert(simd::is_simd_arithmetic_v<T>, "FixedArray::count requires an arithmetic element type");
+        return simd::dispatch([&](auto kernels) { return kernels.count(data_, N, value); });
+    }
+
+    iterator find(const T& value) {
+        return begin() + static_cast<difference_type>(find_index(value));
+    }
 
-    // Operations
-    void fill(const T& value) {
-        std::fill(data_, data_ + N, value);
+    const_iterator find(const T& value) const {
+        return begin() + static_cast<difference_type>(find_index(value));
+    }
+
+    // f runs elementwise, still compiled for the selected instruction set.
+    // Wrap it as simd::vectorized([](auto x) { return x * x + 1; }) to run
+    // it on whole vectors instead; only arithmetic the vector types support
+    // (no std::sqrt, std::abs, ...) may appear in a vectorized body.
+    template<typename F>
+    void transform_inplace(F f) {
+        static_assert(simd::is_simd_arithmetic_v<T>, "FixedArray::transform_inplace requires an arithmetic element type");
+        simd::dispatch([&](auto kernels) { kernels.transform(data_, N, f); });
+    }
+
+private:
+    size_type find_index(const T& value) const {
+        static_assert(simd::is_simd_arithmetic_v<T>, "FixedArray::find requires an arithmetic element type");
+        return simd::dispatch([&](auto kernels) { return kernels.find(data_, N, value); });
     }
 };
 
-// Non-member arithmetic operators for iterators
-template<typename T, size_t N>
-typename FixedArray<T, N>::iterator operator+(
-    typename FixedArray<T, N>::iterator::difference_type n,
-    const typename FixedArray<T, N>::iterator& it) {
-    return it + n;
+// ============================================================================
+// Structure-of-Arrays Fixed-Size Container
+// ============================================================================
+
+// Proxy for one SoA record; behaves like std::tuple<Fields&...> with value
+// semantics on assignment (copies field values, never rebinds)
+template<typename... Fields>
+class SoAReference : public std::tuple<Fields&...> {
+public:
+    using base = std::tuple<Fields&...>;
+    using value_type = std::tuple<Fields...>;
+    using base::base;
+    using base::operator=;
+
+    constexpr SoAReference(const SoAReference&) = default;
+
+    SoAReference& operator=(const SoAReference& other) {
+        base::operator=(static_cast<const base&>(other));
+        return *this;
+    }
+
+    SoAReference& operator=(const value_type& value) {
+        base::operator=(value);
+        return *this;
+    }
+
+    SoAReference& operator=(value_type&& value) {
+        base::operator=(std::move(value));
+        return *this;
+    }
+
+    // Swaps the referenced field values (what std::iter_swap needs)
+    friend void swap(SoAReference a, SoAReference b) {
+        value_type temp(std::move(a));
+        a = std::move(b);
+        b = std::move(temp);
+    }
+};
+
+template<typename... Fields>
+class SoAConstReference : public std::tuple<const Fields&...> {
+public:
+    using base = std::tuple<const Fields&...>;
+    using base::base;
+
+    constexpr SoAConstReference(const SoAReference<Fields...>& other) : base(other) {}
+    SoAConstReference& operator=(const SoAConstReference&) = delete;
+};
+
+// Tuple protocol, so structured bindings decompose a record proxy
+namespace std {
+template<typename... Fields>
+struct tuple_size<SoAReference<Fields...>> : std::integral_constant<size_t, sizeof...(Fields)> {};
+
+template<size_t I, typename... Fields>
+struct tuple_element<I, SoAReference<Fields...>> : tuple_element<I, tuple<Fields&...>> {};
+
+template<typename... Fields>
+struct tuple_size<SoAConstReference<Fields...>> : std::integral_constant<size_t, sizeof...(Fields)> {};
+
+template<size_t I, typename... Fields>
+struct tuple_element<I, SoAConstReference<Fields...>> : tuple_element<I, tuple<const Fields&...>> {};
+}  // namespace std
+
+// SoAFixedArray<N, Fields...> stores N records of (Fields...), with each field
+// in its own FixedArray column. A loop over one field touches only that
+// field's cache lines, and field<I>() exposes the column (contiguous,
+// 64-byte aligned, with the SIMD kernels above) for vectorized loops.
+// Iterators are random access and dereference to an SoAReference proxy: a
+// std::tuple of references into the columns. Assigning through it writes the
+// fields, and it converts to value_type (std::tuple<Fields...>), so
+// std::sort, std::transform and std::get work on whole records.
+template<size_t N, typename... Fields>
+class SoAFixedArray {
+    static_assert(sizeof...(Fields) > 0, "SoAFixedArray needs at least one field");
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+
+    template<size_t I>
+    using field_type = std::tuple_element_t<I, value_type>;
+
+    template<size_t I>
+    using column_type = FixedArray<field_type<I>, N>;
+
+    using reference = SoAReference<Fields...>;
+    using const_reference = SoAConstReference<Fields...>;
+
+private:
+    std::tuple<FixedArray<Fields, N>...> columns_;
+
+    template<size_t... I>
+    reference make_reference(size_type index, std::index_sequence<I...>) noexcept {
+        return reference(std::get<I>(columns_)[index]...);
+    }
+
+    template<size_t... I>
+    const_reference make_reference(size_type index, std::index_sequence<I...>) const noexcept {
+        return const_reference(std::get<I>(columns_)[index]...);
+    }
+
+    template<bool IsConst>
+    class iterator_impl {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = SoAFixedArray::value_type;
+        using difference_type = SoAFixedArray::difference_type;
+        using reference = std::conditional_t<IsConst, SoAFixedArray::const_reference, SoAFixedArray::reference>;
+        using pointer = void;  // Records are not objects in memory
+
+    private:
+        using container = std::conditional_t<IsConst, const SoAFixedArray, SoAFixedArray>;
+
+        container* array_;
+        difference_type index_;
+
+        friend class iterator_impl<!IsConst>;
+
+    public:
+        constexpr iterator_impl() noexcept : array_(nullptr), index_(0) {}
+        constexpr iterator_impl(container* array, difference_type index) noexcept : array_(array), index_(index) {}
+
+        // Every iterator converts to a const_iterator
+        template<bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+        constexpr iterator_impl(const iterator_impl<OtherConst>& other) noexcept
+            : array_(other.array_), index_(other.index_) {}
+
+        reference operator*() const noexcept { return (*array_)[static_cast<size_type>(index_)]; }
+        reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+        constexpr difference_type index() const noexcept { return index_; }
+
+        constexpr iterator_impl& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        constexpr iterator_impl operator++(int) noexcept {
+            iterator_impl temp = *this;
+            ++index_;
+            return temp;
+        }
+
+        constexpr iterator_impl& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        constexpr iterator_impl operator--(int) noexcept {
+            iterator_impl temp = *this;
+            --index_;
+            return temp;
+        }
+
+        constexpr iterator_impl& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        constexpr iterator_impl& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        constexpr iterator_impl operator+(difference_type n) const noexcept {
+            return iterator_impl(array_, index_ + n);
+        }
+
+        constexpr iterator_impl operator-(difference_type n) const noexcept {
+            return iterator_impl(array_, index_ - n);
+        }
+
+        friend constexpr iterator_impl operator+(difference_type n, const iterator_impl& it) noexcept {
+            return it + n;
+        }
+
+        constexpr difference_type operator-(const iterator_impl& other) const noexcept {
+            return index_ - other.index_;
+        }
+
+        constexpr bool operator==(const iterator_impl& other) const noexcept { return index_ == other.index_; }
+        constexpr bool operator!=(const iterator_impl& other) const noexcept { return index_ != other.index_; }
+        constexpr bool operator<(const iterator_impl& other) const noexcept { return index_ < other.index_; }
+        constexpr bool operator>(const iterator_impl& other) const noexcept { return index_ > other.index_; }
+        constexpr bool operator<=(const iterator_impl& other) const noexcept { return index_ <= other.index_; }
+        constexpr bool operator>=(const iterator_impl& other) const noexcept { return index_ >= other.index_; }
+    };
+
+public:
+    using iterator = iterator_impl<false>;
+    using const_iterator = iterator_impl<true>;
+
+    // Constructors
+    SoAFixedArray() = default;
+
+    SoAFixedArray(std::initializer_list<value_type> init) {
+        size_type i = 0;
+        for (const auto& record : init) {
+            if (i == N) {
+                break;
+            }
+            (*this)[i++] = record;
+        }
+    }
+
+    // Record access
+    reference operator[](size_type index) noexcept {
+        return make_reference(index, std::index_sequence_for<Fields...>{});
+    }
+
+    const_reference operator[](size_type index) const noexcept {
+        return make_reference(index, std::index_sequence_for<Fields...>{});
+    }
+
+    reference at(size_type index) {
+        if (index >= N) {
+            throw std::out_of_range("SoAFixedArray::at: index out of range");
+        }
+        return (*this)[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= N) {
+            throw std::out_of_range("SoAFixedArray::at: index out of range");
+        }
+        return (*this)[index];
+    }
+
+    // Per-field columns: contiguous storage for vectorized loops
+    template<size_t I>
+    column_type<I>& field() noexcept { return std::get<I>(columns_); }
+
+    template<size_t I>
+    const column_type<I>& field() const noexcept { return std::get<I>(columns_); }
+
+    // Iterators
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, static_cast<difference_type>(N)); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, static_cast<difference_type>(N)); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // Capacity
+    constexpr size_type size() const noexcept { return N; }
+    constexpr bool empty() const noexcept { return N == 0; }
+    constexpr size_type max_size() const noexcept { return N; }
+    static constexpr size_type field_count() noexcept { return sizeof...(Fields); }
+};
+
+// ============================================================================
+// Parallel Algorithms on the Work-Stealing Pool
+// ============================================================================
+
+// Execution policies, modeled on std::execution (whose parallel backend
+// libstdc++ only provides with TBB). par(pool) runs on an exercise 3
+// WorkStealingPool; ranges too small to amortize task overhead run serially.
+namespace execution {
+
+struct sequenced_policy {};
+
+struct parallel_policy {
+    WorkStealingPool* pool;
+    size_t grain = 0;  // Elements per chunk; 0 picks one from the range size
+};
+
+inline constexpr sequenced_policy seq{};
+
+inline parallel_policy par(WorkStealingPool& pool, size_t grain = 0) {
+    return parallel_policy{&pool, grain};
 }
 
-template<typename T, size_t N>
-typename FixedArray<T, N>::const_iterator operator+(
-    typename FixedArray<T, N>::const_iterator::difference_type n,
-    const typename FixedArray<T, N>::const_iterator& it) {
-    return it + n;
+}  // namespace execution
+
+namespace detail {
+
+// Below this many bytes a range runs serially: splitting costs more than it saves
+constexpr size_t parallel_min_bytes = 32 * 1024;
+
+// Chunks per worker, so stealing can balance uneven chunks
+constexpr size_t chunks_per_thread = 4;
+
+// Elements per chunk, a whole number of cache lines so neighbouring chunks
+// never write the same line (FixedArray storage starts on a line boundary).
+// Returns 0 when the range should stay serial.
+template<typename T>
+size_t chunk_size(size_t n, const execution::parallel_policy& policy) {
+    constexpr size_t per_line = std::max<size_t>(1, cache_line_size / sizeof(T));
+    size_t grain = policy.grain;
+    if (grain == 0) {
+        if (n * sizeof(T) < parallel_min_bytes || policy.pool->thread_count() < 2) {
+            return 0;
+        }
+        size_t chunks = policy.pool->thread_count() * chunks_per_thread;
+        grain = std::max((n + chunks - 1) / chunks, parallel_min_bytes / sizeof(T) / 4);
+    }
+    grain = (grain + per_line - 1) / per_line * per_line;
+    return grain < n ? grain : 0;
+}
+
+// Run fn(chunk_begin, chunk_end) for each chunk of [0, n) on the pool
+template<typename Function>
+void for_each_chunk(const execution::parallel_policy& policy, size_t n, size_t chunk, Function fn) {
+    size_t chunks = (n + chunk - 1) / chunk;
+    policy.pool->parallel_for(0, chunks, 1, [&](size_t c) {
+        size_t begin = c * chunk;
+        fn(begin, std::min(begin + chunk, n));
+    });
+}
+
+}  // namespace detail
+
+// Sort [first, last): chunks are sorted in parallel, then merged pairwise in
+// parallel rounds
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_sort(execution::sequenced_policy, RandomIt first, RandomIt last, Compare comp = {}) {
+    std::sort(first, last, comp);
+}
+
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_sort(const execution::parallel_policy& policy, RandomIt first, RandomIt last, Compare comp = {}) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    size_t n = static_cast<size_t>(last - first);
+    size_t chunk = detail::chunk_size<T>(n, policy);
+    if (chunk == 0) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    detail::for_each_chunk(policy, n, chunk, [&](size_t begin, size_t end) {
+        std::sort(first + begin, first + end, comp);
+    });
+
+    for (size_t width = chunk; width < n; width *= 2) {
+        size_t pairs = (n + 2 * width - 1) / (2 * width);
+        policy.pool->parallel_for(0, pairs, 1, [&](size_t pair) {
+            size_t begin = pair * 2 * width;
+            size_t mid = std::min(begin + width, n);
+            size_t end = std::min(begin + 2 * width, n);
+            std::inplace_merge(first + begin, first + mid, first + end, comp);
+        });
+    }
+}
+
+// d_first[i] = op(first[i]); the output range must not partially overlap the input
+template<typename InputIt, typename OutputIt, typename UnaryOp>
+OutputIt parallel_transform(execution::sequenced_policy, InputIt first, InputIt last, OutputIt d_first, UnaryOp op) {
+    return std::transform(first, last, d_first, op);
+}
+
+template<typename InputIt, typename OutputIt, typename UnaryOp>
+OutputIt parallel_transform(const execution::parallel_policy& policy, InputIt first, InputIt last,
+                            OutputIt d_first, UnaryOp op) {
+    using T = typename std::iterator_traits<OutputIt>::value_type;
+    size_t n = static_cast<size_t>(last - first);
+    size_t chunk = detail::chunk_size<T>(n, policy);
+    if (chunk == 0) {
+        return std::transform(first, last, d_first, op);
+    }
+
+    detail::for_each_chunk(policy, n, chunk, [&](size_t begin, size_t end) {
+        std::transform(first + begin, first + end, d_first + begin, op);
+    });
+    return d_first + static_cast<std::ptrdiff_t>(n);
+}
+
+// Fold [first, last) with op, which must be associative: each chunk is
+// reduced on its own, then the partial results are combined in order
+template<typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+T parallel_reduce(execution::sequenced_policy, RandomIt first, RandomIt last, T init, BinaryOp op = {}) {
+    return std::accumulate(first, last, std::move(init), op);
 }
 
+template<typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+T parallel_reduce(const execution::parallel_policy& policy, RandomIt first, RandomIt last, T init, BinaryOp op = {}) {
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+    size_t n = static_cast<size_t>(last - first);
+    size_t chunk = detail::chunk_size<Value>(n, policy);
+    if (chunk == 0) {
+        return std::accumulate(first, last, std::move(init), op);
+    }
+
+    // One padded slot per chunk so workers never share a cache line
+    struct alignas(cache_line_size) Partial {
+        std::optional<T> value;
+    };
+    std::vector<Partial> partials((n + chunk - 1) / chunk);
+
+    detail::for_each_chunk(policy, n, chunk, [&](size_t begin, size_t end) {
+        T acc = first[begin];
+        for (size_t i = begin + 1; i < end; ++i) {
+            acc = op(std::move(acc), first[i]);
+        }
+        partials[begin / chunk].value.emplace(std::move(acc));
+    });
+
+    for (Partial& partial : partials) {
+        init = op(std::move(init), std::move(*partial.value));
+    }
+    return init;
+}
+
+// Whole-container overloads for FixedArray and SoA columns
+template<typename Policy, typename T, size_t N, typename Compare = std::less<>>
+void parallel_sort(const Policy& policy, FixedArray<T, N>& array, Compare comp = {}) {
+    parallel_sort(policy, array.begin(), array.end(), comp);
+}
+
+template<typename Policy, typename T, size_t N, typename U, typename UnaryOp>
+void parallel_transform(const Policy& policy, const FixedArray<T, N>& in, FixedArray<U, N>& out, UnaryOp op) {
+    parallel_transform(policy, in.begin(), in.end(), out.begin(), op);
+}
+
+template<typename Policy, typename T, size_t N, typename R, typename BinaryOp = std::plus<>>
+R parallel_reduce(const Policy& policy, const FixedArray<T, N>& array, R init, BinaryOp op = {}) {
+    return parallel_reduce(policy, array.begin(), array.end(), std::move(init), op);
+}
+
+// Other files include this one for its containers and algorithms; they define
+// EXERCISE_5_NO_MAIN to leave out the tests and main()
+#ifndef EXERCISE_5_NO_MAIN
+
 // ============================================================================
 // Test Functions
 // ============================================================================
@@ -461,6 +1396,255 @@ void test_iterator_traits() {
     std::cout << "  Reference type: " << typeid(typename traits::reference).name() << "\n\n";
 }
 
+// Compares every kernel with the matching std algorithm on a pattern that
+// exercises full vector blocks plus a scalar tail
+template<typename T, size_t N>
+bool simd_matches_std() {
+    FixedArray<T, N> a;
+    FixedArray<T, N> b;
+    for (size_t i = 0; i < N; ++i) {
+        a[i] = static_cast<T>((i * 7) % 23);
+        b[i] = static_cast<T>((i * 3) % 5);
+    }
+    a[N - 1] = static_cast<T>(40);  // Max sits in the tail
+    a[N / 2] = static_cast<T>(-1);  // Min (or wrapped max for unsigned) mid-array
+
+    bool ok = a.sum() == std::accumulate(a.begin(), a.end(), T{});
+    ok = ok && a.min() == *std::min_element(a.begin(), a.end());
+    ok = ok && a.max() == *std::max_element(a.begin(), a.end());
+    ok = ok && a.dot(b) == std::inner_product(a.begin(), a.end(), b.begin(), T{});
+    ok = ok && a.count(static_cast<T>(7)) == static_cast<size_t>(std::count(a.begin(), a.end(), static_cast<T>(7)));
+    ok = ok && a.find(static_cast<T>(40)) == std::find(a.begin(), a.end(), static_cast<T>(40));
+    ok = ok && a.find(static_cast<T>(99)) == a.end();
+
+    FixedArray<T, N> expected = a;
+    std::transform(expected.begin(), expected.end(), expected.begin(), [](T x) { return static_cast<T>(x * 2 + 1); });
+    a.transform_inplace(simd::vectorized([](auto x) { return x * 2 + 1; }));
+    ok = ok && std::equal(a.begin(), a.end(), expected.begin());
+
+    // A generic lambda whose body only works on scalars stays elementwise
+    auto magnitude = [](auto x) { return static_cast<T>(std::abs(static_cast<long double>(x))); };
+    FixedArray<T, N> scalar_only = a;
+    std::transform(a.begin(), a.end(), expected.begin(), magnitude);
+    scalar_only.transform_inplace(magnitude);
+    ok = ok && std::equal(scalar_only.begin(), scalar_only.end(), expected.begin());
+    return ok;
+}
+
+void test_simd_kernels() {
+    std::cout << "=== Test 9: Vectorized Bulk Operations ===\n";
+    std::cout << "  Dispatching to: " << simd::isa_name(simd::active_isa()) << "\n";
+
+    FixedArray<float, 16> features{0.5f, 1.5f, -2.0f, 4.0f, 3.0f, 0.25f, -1.0f, 2.0f,
+                                   1.0f, 1.0f, 1.0f, 1.0f, 2.0f, 2.0f, 2.0f, 2.0f};
+    FixedArray<float, 16> weights;
+    weights.fill(0.5f);
+    std::cout << "  Storage 64-byte aligned: "
+              << (reinterpret_cast<std::uintptr_t>(features.data()) % 64 == 0 ? "yes" : "no") << "\n";
+    std::cout << "  sum: " << features.sum() << ", min: " << features.min() << ", max: " << features.max()
+              << ", dot(weights): " << features.dot(weights) << "\n";
+    std::cout << "  count(1.0): " << features.count(1.0f)
+              << ", find(3.0) at index: " << (features.find(3.0f) - features.begin()) << "\n";
+
+    features.transform_inplace(simd::vectorized([](auto x) { return x * 2.0f; }));  // Full-width path
+    features.transform_inplace([](float x) { return x < 0.0f ? 0.0f : x; });  // Elementwise path
+    features.transform_inplace([](auto x) { return std::sqrt(x); });  // Generic, scalar-only body: elementwise
+    std::cout << "  Doubled, clamped, square-rooted: ";
+    for (size_t i = 0; i < 8; ++i) {
+        std::cout << features[i] << " ";
+    }
+    std::cout << "...\n";
+
+    bool all_match = simd_matches_std<int8_t, 300>() && simd_matches_std<uint8_t, 301>() &&
+                     simd_matches_std<int16_t, 77>() && simd_matches_std<int32_t, 131>() &&
+                     simd_matches_std<uint32_t, 3>() && simd_matches_std<int64_t, 67>() &&
+                     simd_matches_std<float, 100>() && simd_matches_std<double, 45>();
+    std::cout << "  Kernels match std algorithms for all element types: " << (all_match ? "yes" : "no") << "\n\n";
+}
+
+// Compile-time lookup tables: these live in .rodata, no startup code runs
+constexpr FixedArray<int, 4> primes{2, 3, 5, 7};
+
+constexpr FixedArray<unsigned, 16> make_square_table() {
+    FixedArray<unsigned, 16> table;
+    for (size_t i = 0; i < table.size(); ++i) {
+        table[i] = static_cast<unsigned>(i * i);
+    }
+    return table;
+}
+
+constexpr FixedArray<unsigned, 16> squares = make_square_table();
+
+static_assert(primes[3] == 7, "initializer_list constructor is constexpr");
+static_assert(*(primes.begin() + 2) == 5 && primes.end() - primes.begin() == 4, "iterators are constexpr");
+static_assert(squares[15] == 225 && *(1 + squares.cbegin()) == 1, "tables build at compile time");
+static_assert(noexcept(++std::declval<FixedArray<int, 4>::iterator&>()), "iterator steps are noexcept");
+#ifdef __cpp_lib_ranges
+static_assert(std::contiguous_iterator<FixedArray<int, 4>::iterator>);
+static_assert(std::contiguous_iterator<FixedArray<int, 4>::const_iterator>);
+#endif
+
+void test_constexpr_tables() {
+    std::cout << "=== Test 10: Constexpr Tables and Contiguous Iterators ===\n";
+
+    std::cout << "  Compile-time squares: ";
+    for (auto it = squares.begin(); it != squares.begin() + 6; ++it) {
+        std::cout << *it << " ";
+    }
+    std::cout << "...\n";
+
+    // Contiguous storage: the iterator range is the data() range
+    FixedArray<int, 4> copy;
+    std::copy(primes.begin(), primes.end(), copy.begin());
+    FixedArray<int, 4>::const_iterator converted = copy.begin();
+    std::cout << "  Copied primes: ";
+    for (; converted != copy.cend(); ++converted) {
+        std::cout << *converted << " ";
+    }
+    std::cout << "\n";
+    std::cout << "  Iterator addresses match data(): "
+              << (&*(copy.begin() + 3) == copy.data() + 3 ? "yes" : "no") << "\n";
+    std::cout << "  Ranges equal: " << (std::equal(copy.begin(), copy.end(), primes.begin()) ? "yes" : "no") << "\n\n";
+}
+
+void test_soa_container() {
+    std::cout << "=== Test 11: Structure-of-Arrays Container ===\n";
+
+    // Particles as (x, velocity, id), each field in its own column
+    SoAFixedArray<6, float, float, int> particles{
+        {4.0f, 0.5f, 0}, {1.0f, 2.0f, 1}, {5.0f, -1.0f, 2},
+        {2.0f, 1.5f, 3}, {3.0f, 0.0f, 4}, {0.5f, 3.0f, 5}};
+
+    // Sort whole records by x through the proxy iterator
+    std::sort(particles.begin(), particles.end(),
+              [](const auto& a, const auto& b) { return std::get<0>(a) < std::get<0>(b); });
+    std::cout << "  Sorted by x (id order): ";
+    for (const auto& p : particles) {
+        std::cout << std::get<2>(p) << " ";
+    }
+    std::cout << "\n";
+
+    // Record-wise transform: integrate one step, x += velocity
+    std::transform(particles.begin(), particles.end(), particles.begin(), [](const auto& p) {
+        auto [x, velocity, id] = p;
+        return std::make_tuple(x + velocity, velocity, id);
+    });
+    std::cout << "  After one step, x: ";
+    for (float x : particles.field<0>()) {
+        std::cout << x << " ";
+    }
+    std::cout << "\n";
+
+    // Field column: contiguous, aligned, and vectorized
+    auto& velocity = particles.field<1>();
+    std::cout << "  Velocity column: sum " << velocity.sum() << ", max " << velocity.max()
+              << ", aligned: " << (reinterpret_cast<std::uintptr_t>(velocity.data()) % 64 == 0 ? "yes" : "no") << "\n";
+
+    // Default ordering compares records lexicographically
+    std::sort(particles.begin(), particles.end());
+    std::cout << "  Record at index 0 after default sort: (" << std::get<0>(particles[0]) << ", "
+              << std::get<1>(particles[0]) << ", " << std::get<2>(particles[0]) << ")\n\n";
+}
+
+void test_parallel_algorithms() {
+    std::cout << "=== Test 12: Parallel Algorithms ===\n";
+
+    WorkStealingPool pool(4);
+    constexpr size_t n = 1 << 18;
+    auto values = std::make_unique<FixedArray<int, n>>();
+    uint32_t state = 12345;
+    for (auto& v : *values) {
+        state = state * 1664525u + 1013904223u;  // LCG: deterministic input
+        v = static_cast<int>(state >> 8) % 100000;
+    }
+    auto expected = std::make_unique<FixedArray<int, n>>(*values);
+
+    parallel_sort(execution::par(pool), *values);
+    std::sort(expected->begin(), expected->end());
+    std::cout << "  parallel_sort matches std::sort: "
+              << (std::equal(values->begin(), values->end(), expected->begin()) ? "yes" : "no") << "\n";
+
+    auto squares = std::make_unique<FixedArray<long long, n>>();
+    parallel_transform(execution::par(pool), *values, *squares, [](int x) { return 1LL * x * x; });
+    bool transform_ok = true;
+    for (size_t i = 0; i < n; i += 997) {
+        transform_ok = transform_ok && (*squares)[i] == 1LL * (*values)[i] * (*values)[i];
+    }
+    std::cout << "  parallel_transform correct: " << (transform_ok ? "yes" : "no") << "\n";
+
+    long long total = parallel_reduce(execution::par(pool), *squares, 0LL);
+    long long serial = std::accumulate(squares->begin(), squares->end(), 0LL);
+    std::cout << "  parallel_reduce matches std::accumulate: " << (total == serial ? "yes" : "no") << "\n";
+
+    // Small ranges stay serial; seq always does
+    FixedArray<int, 8> small{5, 3, 8, 1, 9, 2, 7, 4};
+    parallel_sort(execution::par(pool), small);
+    int product = parallel_reduce(execution::seq, small, 1, std::multiplies<>{});
+    std::cout << "  Small array sorted serially: ";
+    for (int x : small) {
+        std::cout << x << " ";
+    }
+    std::cout << "(product " << product << ")\n";
+    std::cout << "  Chunk for 1M ints on 4 threads: "
+              << detail::chunk_size<int>(1 << 20, execution::par(pool)) << " elements, for 64 ints: "
+              << detail::chunk_size<int>(64, execution::par(pool)) << " (serial)\n\n";
+}
+
+// Returns false if iterating a FixedArray copied an element or allocated
+bool test_hot_path_tracking() {
+    std::cout << "=== Test 13: Copy-Free, Allocation-Free Iteration ===\n";
+    using Name = tracking::Tracked<std::string>;
+    bool clean = true;
+    auto report = [&clean](const char* path, const tracking::Counts& counts, bool hot) {
+        std::cout << "  " << path << ": " << counts.copies() << " copies, " << counts.moves() << " moves, "
+                  << counts.allocations() << " allocations\n";
+        if (hot) {
+            clean = clean && counts.copies() == 0 && counts.allocations() == 0;
+        }
+    };
+
+    FixedArray<Name, 16> names;
+    for (size_t i = 0; i < names.size(); ++i) {
+        names[i] = Name(std::string(32, static_cast<char>('p' - i)));
+    }
+    {
+        tracking::Scope scope(TRACKING_SITE("FixedArray iteration"));
+        size_t total = 0;
+        for (const Name& name : names) {
+            total += name->size();
+        }
+        const auto& view = names;
+        auto long_names = std::count_if(view.cbegin(), view.cend(), [](const Name& name) { return name->size() > 8; });
+        auto found = std::find_if(std::make_reverse_iterator(view.end()), std::make_reverse_iterator(view.begin()),
+                                  [](const Name& name) { return (*name)[0] == 'p'; });
+        report("range-for, count_if, reverse find_if", scope.counts(), true);
+        std::cout << "  (" << total << " chars, " << long_names << " long names, found: "
+                  << (found != std::make_reverse_iterator(view.begin()) ? "yes" : "no") << ")\n";
+    }
+    {
+        tracking::Scope scope(TRACKING_SITE("FixedArray sort"));
+        std::sort(names.begin(), names.end(), [](const Name& a, const Name& b) { return *a < *b; });
+        report("std::sort through iterators (moves only)", scope.counts(), true);
+    }
+    {
+        FixedArray<int, 1024> values;
+        std::iota(values.begin(), values.end(), 0);
+        tracking::Scope scope(TRACKING_SITE("FixedArray bulk"));
+        int sum = values.sum();
+        long long accumulated = std::accumulate(values.cbegin(), values.cend(), 0LL);
+        report("sum() + std::accumulate", scope.counts(), true);
+        std::cout << "  (sum " << sum << ", accumulate " << accumulated << ")\n";
+    }
+    {
+        tracking::Scope scope(TRACKING_SITE("FixedArray copy into vector"));
+        std::vector<Name> copy(names.begin(), names.end());
+        report("Copying into a vector (expected to be caught)", scope.counts(), false);
+    }
+
+    std::cout << "  Iteration copy-free and allocation-free: " << (clean ? "yes" : "no") << "\n\n";
+    return clean;
+}
+
 int main() {
     std::cout << "=== Exercise 5: Advanced STL Usage - Custom Iterator ===\n\n";
 
@@ -472,8 +1656,14 @@ int main() {
     test_sort_algorithm();
     test_reverse_iterator();
     test_iterator_traits();
+    test_simd_kernels();
+    test_constexpr_tables();
+    test_soa_container();
+    test_parallel_algorithms();
+    bool hot_paths_clean = test_hot_path_tracking();
 
     std::cout << "All tests completed!\n";
-    return 0;
+    return hot_paths_clean ? 0 : 1;
 }
 
+#endif  // EXERCISE_5_NO_MAIN
@@ -1,22 +1,32 @@
 #include <iostream>
+#include <new>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "../common/interning.h"
+#include "../common/layout.h"
+#include "../common/sharded_counter.h"
 
 class Base {
+    friend struct LayoutMembers<Base>;
+
 private:
-    std::string name_;
-    static int instance_count_;
+    InternedName name_;  // 4-byte id instead of a std::string per object
+    static ShardedCounter instance_count_;
 
 public:
-    Base(const std::string& name) : name_(name) {
-        ++instance_count_;
+    Base(std::string_view name, std::string_view suffix = {}) : name_(name, suffix) {
+        instance_count_.increment();
         std::cout << "Base(" << name_ << ") constructed. Total instances: " 
-                  << instance_count_ << std::endl;
+                  << getInstanceCount() << std::endl;
     }
 
     virtual ~Base() {
-        --instance_count_;
+        instance_count_.decrement();
         std::cout << "Base(" << name_ << ") destructed. Remaining instances: " 
-                  << instance_count_ << std::endl;
+                  << getInstanceCount() << std::endl;
     }
 
     virtual void show() const {
@@ -24,19 +34,21 @@ public:
     }
 
     static int getInstanceCount() {
-        return instance_count_;
+        return static_cast<int>(instance_count_.sum());
     }
 };
 
-int Base::instance_count_ = 0;
+ShardedCounter Base::instance_count_;
 
 class Derived1 : public virtual Base {
+    friend struct LayoutMembers<Derived1>;
+
 private:
     int value1_;
 
 public:
-    Derived1(const std::string& name, int v1) 
-        : Base(name + "_D1"), value1_(v1) {
+    Derived1(std::string_view name, int v1) 
+        : Base(name, "_D1"), value1_(v1) {
         std::cout << "Derived1(" << name << ", " << v1 << ") constructed" << std::endl;
     }
 
@@ -51,12 +63,14 @@ public:
 };
 
 class Derived2 : public virtual Base {
+    friend struct LayoutMembers<Derived2>;
+
 private:
     int value2_;
 
 public:
-    Derived2(const std::string& name, int v2) 
-        : Base(name + "_D2"), value2_(v2) {
+    Derived2(std::string_view name, int v2) 
+        : Base(name, "_D2"), value2_(v2) {
         std::cout << "Derived2(" << name << ", " << v2 << ") constructed" << std::endl;
     }
 
@@ -71,11 +85,13 @@ public:
 };
 
 class Final : public Derived1, public Derived2 {
+    friend struct LayoutMembers<Final>;
+
 private:
     int finalValue_;
 
 public:
-    Final(const std::string& name, int v1, int v2, int fv)
+    Final(std::string_view name, int v1, int v2, int fv)
         : Base(name),
           Derived1(name, v1),
           Derived2(name, v2),
@@ -95,7 +111,53 @@ public:
     }
 };
 
-int main() {
+template<>
+struct LayoutMembers<Base> {
+    using bases = std::tuple<>;
+
+    template<typename Visitor>
+    static void members(const Base& object, Visitor& visit) { visit(object.name_); }
+};
+
+template<>
+struct LayoutMembers<Derived1> {
+    using bases = std::tuple<Base>;
+
+    template<typename Visitor>
+    static void members(const Derived1& object, Visitor& visit) { visit(object.value1_); }
+};
+
+template<>
+struct LayoutMembers<Derived2> {
+    using bases = std::tuple<Base>;
+
+    template<typename Visitor>
+    static void members(const Derived2& object, Visitor& visit) { visit(object.value2_); }
+};
+
+template<>
+struct LayoutMembers<Final> {
+    using bases = std::tuple<Derived1, Derived2>;
+
+    template<typename Visitor>
+    static void members(const Final& object, Visitor& visit) { visit(object.finalValue_); }
+};
+
+int main(int argc, char* argv[]) {
+    // CI mode: print only the measured layout of Final so it can be diffed
+    // against a baseline (exercise 6 --layout-json covers its own hierarchies)
+    if (argc > 1 && std::string_view(argv[1]) == "--layout-json") {
+        std::vector<LayoutReport> reports;
+        {
+            SilenceCout silence;
+            reports.push_back(LayoutReport::measure<Final, Derived1, Derived2, Base>(
+                "Final", {"Derived1", "Derived2", "Base"},
+                [](void* p) { return new (p) Final("Layout", 1, 2, 3); }));
+        }
+        write_layout_json(std::cout, reports, 1000000);
+        return 0;
+    }
+
     std::cout << "=== Creating Final object ===" << std::endl;
     Final obj("Test", 10, 20, 30);
     
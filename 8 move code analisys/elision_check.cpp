@@ -0,0 +1,115 @@
+// Copy/move elision regression check for the exercise 8 scenarios.
+//
+// Runs funcByValue, funcByRef, funcByRvalueRef and returnByValue (plus the
+// explicit-move and vector cases) and compares the copies and moves each
+// one performs, as counted by TrackedResource through the tracking layer,
+// against what C++17 guarantees or what GCC/Clang reliably do (NRVO).
+// Exits non-zero if any scenario copies more, or moves more, than
+// expected; verify_elision.sh builds it under several compilers and
+// optimization levels so an accidental `return std::move(local)` or a
+// by-value parameter that starts copying fails the check.
+//
+// Build: g++ -std=c++17 elision_check.cpp -o elision_check
+
+#define EXERCISE_8_NO_MAIN
+#include "exercise_8_solution.cpp"
+
+#include <vector>
+
+#include "../common/layout.h"
+
+// Moving must stay noexcept, or std::vector falls back to copying on growth
+static_assert(std::is_nothrow_move_constructible_v<TrackedResource>, "TrackedResource move must be noexcept");
+static_assert(std::is_nothrow_move_assignable_v<TrackedResource>, "TrackedResource move assignment must be noexcept");
+
+namespace {
+
+struct Scenario {
+    const char* name;
+    uint64_t copies;     // Exact: any extra copy is a regression
+    uint64_t max_moves;  // Upper bound: a move that was elided must stay elided
+    void (*run)();
+};
+
+void by_value_lvalue() {
+    TrackedResource obj(20);
+    funcByValue(obj);
+}
+
+void by_value_prvalue() {
+    funcByValue(TrackedResource(30));  // Guaranteed elision since C++17
+}
+
+void by_value_xvalue() {
+    TrackedResource obj(35);
+    funcByValue(std::move(obj));
+}
+
+void by_ref() {
+    TrackedResource obj(40);
+    funcByRef(obj);
+}
+
+void by_rvalue_ref() {
+    funcByRvalueRef(TrackedResource(50));
+}
+
+void return_by_value() {
+    TrackedResource obj = returnByValue();  // NRVO, then guaranteed elision
+    (void)obj;
+}
+
+void vector_push_back_rvalue() {
+    std::vector<TrackedResource> vec;
+    vec.reserve(1);
+    vec.push_back(TrackedResource(200));
+}
+
+void vector_emplace_back() {
+    std::vector<TrackedResource> vec;
+    vec.reserve(1);
+    vec.emplace_back(250);
+}
+
+const Scenario scenarios[] = {
+    {"funcByValue(lvalue)", 1, 0, by_value_lvalue},
+    {"funcByValue(prvalue)", 0, 0, by_value_prvalue},
+    {"funcByValue(std::move(obj))", 0, 1, by_value_xvalue},
+    {"funcByRef(lvalue)", 0, 0, by_ref},
+    {"funcByRvalueRef(prvalue)", 0, 0, by_rvalue_ref},
+    {"returnByValue()", 0, 0, return_by_value},
+    {"vector::push_back(prvalue)", 0, 1, vector_push_back_rvalue},
+    {"vector::emplace_back(args)", 0, 0, vector_emplace_back},
+};
+
+}  // namespace
+
+int main() {
+    struct Result {
+        const Scenario* scenario;
+        tracking::Counts counts;
+    };
+    std::vector<Result> results;
+    {
+        // Swallows TrackedResource's lifecycle logging; std::cout is
+        // restored even if a scenario throws
+        SilenceCout silence;
+        for (const Scenario& scenario : scenarios) {
+            tracking::Scope scope(TRACKING_SITE("elision scenario"));
+            scenario.run();
+            results.push_back(Result{&scenario, scope.counts()});
+        }
+    }
+
+    int failures = 0;
+    for (const Result& result : results) {
+        const Scenario& s = *result.scenario;
+        bool ok = result.counts.copies() == s.copies && result.counts.moves() <= s.max_moves;
+        failures += !ok;
+        std::cout << (ok ? "  ok    " : "  FAIL  ") << s.name << ": " << result.counts.copies() << " copies (expected "
+                  << s.copies << "), " << result.counts.moves() << " moves (at most " << s.max_moves << ")\n";
+    }
+    std::cout << (failures ? "Elision check FAILED: " : "Elision check passed: ") << failures << " of "
+              << sizeof(scenarios) / sizeof(scenarios[0]) << " scenarios regressed\n";
+    return failures ? 1 : 0;
+}
@@ -3,7 +3,16 @@
 #include <string>
 #include <utility>
 
-class TrackedResource {
+#include "../common/tracing.h"
+#include "../common/tracking.h"
+
+// ============================================================================
+// Exercise Code
+// ============================================================================
+
+// Also reports through tracking::CountCopies, so its copies and moves show
+// up in the tracking counters and the exit summary
+class TrackedResource : private tracking::CountCopies {
 private:
     int id_;
     static int copy_count_;
@@ -14,28 +23,29 @@ private:
 
 public:
     explicit TrackedResource(int value = 0) : id_(next_id_++) {
-        std::cout << "TrackedResource(" << id_ << ") constructed with value " << value << std::endl;
+        TRACE_INFO("TrackedResource(", id_, ") constructed with value ", value);
     }
 
     // Copy constructor
-    TrackedResource(const TrackedResource& other) : id_(next_id_++) {
+    TrackedResource(const TrackedResource& other) : CountCopies(other), id_(next_id_++) {
         ++copy_count_;
-        std::cout << "TrackedResource(" << id_ << ") copy constructed from " << other.id_ << std::endl;
+        TRACE_DEBUG("TrackedResource(", id_, ") copy constructed from ", other.id_);
     }
 
     // Move constructor
-    TrackedResource(TrackedResource&& other) noexcept : id_(other.id_) {
+    TrackedResource(TrackedResource&& other) noexcept : CountCopies(std::move(other)), id_(other.id_) {
         ++move_count_;
         other.id_ = -1;  // Mark as moved-from
-        std::cout << "TrackedResource(" << id_ << ") move constructed from " << other.id_ << std::endl;
+        TRACE_DEBUG("TrackedResource(", id_, ") move constructed from ", other.id_);
     }
 
     // Copy assignment
     TrackedResource& operator=(const TrackedResource& other) {
         if (this != &other) {
+            CountCopies::operator=(other);
             ++copy_assign_count_;
             id_ = next_id_++;
-            std::cout << "TrackedResource(" << id_ << ") copy assigned from " << other.id_ << std::endl;
+            TRACE_DEBUG("TrackedResource(", id_, ") copy assigned from ", other.id_);
         }
         return *this;
     }
@@ -43,17 +53,18 @@ public:
     // Move assignment
     TrackedResource& operator=(TrackedResource&& other) noexcept {
         if (this != &other) {
+            CountCopies::operator=(std::move(other));
             ++move_assign_count_;
             id_ = other.id_;
             other.id_ = -1;
-            std::cout << "TrackedResource(" << id_ << ") move assigned from " << other.id_ << std::endl;
+            TRACE_DEBUG("TrackedResource(", id_, ") move assigned from ", other.id_);
         }
         return *this;
     }
 
     ~TrackedResource() {
         if (id_ >= 0) {
-            std::cout << "TrackedResource(" << id_ << ") destructed" << std::endl;
+            TRACE_INFO("TrackedResource(", id_, ") destructed");
         }
     }
 
@@ -80,17 +91,17 @@ int TrackedResource::move_assign_count_ = 0;
 int TrackedResource::next_id_ = 1;
 
 // Function taking by value
-void funcByValue(TrackedResource obj) {
+void funcByValue(TrackedResource /*obj*/) {
     std::cout << "funcByValue called" << std::endl;
 }
 
 // Function taking by reference
-void funcByRef(const TrackedResource& obj) {
+void funcByRef(const TrackedResource& /*obj*/) {
     std::cout << "funcByRef called" << std::endl;
 }
 
 // Function taking by rvalue reference
-void funcByRvalueRef(TrackedResource&& obj) {
+void funcByRvalueRef(TrackedResource&& /*obj*/) {
     std::cout << "funcByRvalueRef called" << std::endl;
 }
 
@@ -100,6 +111,11 @@ TrackedResource returnByValue() {
     return temp;  // RVO may apply here, or move if RVO doesn't apply
 }
 
+// Other files include this one for TrackedResource (the tracking layer it
+// builds on is common/tracking.h); they define EXERCISE_8_NO_MAIN to leave
+// out main()
+#ifndef EXERCISE_8_NO_MAIN
+
 int main() {
     TrackedResource::resetCounters();
     
@@ -199,3 +215,4 @@ int main() {
     return 0;
 }
 
+#endif  // EXERCISE_8_NO_MAIN
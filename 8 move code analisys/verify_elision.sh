@@ -0,0 +1,68 @@
+#!/usr/bin/env bash
+# Builds elision_check.cpp with every available compiler at several
+# optimization levels and runs it; fails if any build copies or moves more
+# than the expected counts for the exercise 8 scenarios.
+#
+# The exercise itself is also compiled with -Werror=pessimizing-move and
+# -Werror=redundant-move, which catch `return std::move(local)` at compile
+# time, and one build with -fno-elide-constructors must FAIL the check,
+# proving the harness notices a lost NRVO.
+#
+# Usage: ./verify_elision.sh            (compilers found on PATH)
+#        COMPILERS="g++-12 clang++-16" OPT_LEVELS="-O0 -O2" ./verify_elision.sh
+set -u
+
+here="$(cd "$(dirname "$0")" && pwd)"
+build="$(mktemp -d)"
+trap 'rm -rf "$build"' EXIT
+
+if [ -z "${COMPILERS:-}" ]; then
+    COMPILERS=""
+    for candidate in g++ clang++; do
+        command -v "$candidate" >/dev/null 2>&1 && COMPILERS="$COMPILERS $candidate"
+    done
+fi
+OPT_LEVELS="${OPT_LEVELS:--O0 -O1 -O2 -O3 -Os}"
+
+if [ -z "${COMPILERS// /}" ]; then
+    echo "verify_elision: no C++ compiler found" >&2
+    exit 2
+fi
+
+failed=0
+for cxx in $COMPILERS; do
+    # -Wpessimizing-move and -Wredundant-move are known to GCC >= 9 and Clang
+    if ! "$cxx" -std=c++17 -fsyntax-only -Wall -Werror=pessimizing-move -Werror=redundant-move \
+            "$here/exercise_8_solution.cpp"; then
+        echo "FAIL $cxx: pessimizing or redundant std::move in exercise_8_solution.cpp"
+        failed=1
+    fi
+
+    for opt in $OPT_LEVELS; do
+        binary="$build/elision_check_$(basename "$cxx")$opt"
+        if ! "$cxx" -std=c++17 $opt "$here/elision_check.cpp" -o "$binary"; then
+            echo "FAIL $cxx $opt: build failed"
+            failed=1
+            continue
+        fi
+        if "$binary" >"$binary.log" 2>/dev/null; then
+            echo "ok   $cxx $opt"
+        else
+            echo "FAIL $cxx $opt"
+            sed -n '/FAIL/p' "$binary.log"
+            failed=1
+        fi
+    done
+
+    # Self-test: without NRVO returnByValue() moves, which must be reported
+    binary="$build/elision_check_$(basename "$cxx")_no_elide"
+    if "$cxx" -std=c++17 -O2 -fno-elide-constructors "$here/elision_check.cpp" -o "$binary" &&
+            ! "$binary" >/dev/null 2>&1; then
+        echo "ok   $cxx -fno-elide-constructors (regression detected as expected)"
+    else
+        echo "FAIL $cxx -fno-elide-constructors: lost NRVO went unnoticed"
+        failed=1
+    fi
+done
+
+exit $failed
@@ -0,0 +1,31 @@
+// Exercise 4: Buffer copy against Buffer move
+#define EXERCISE_4_NO_MAIN
+#include "exercise_4_solution.cpp"
+
+#include "harness.h"
+
+namespace {
+
+const bool registered = [] {
+    for (size_t bytes : {size_t{64}, size_t{4096}, size_t{1} << 20}) {
+        std::string suffix = "/" + std::to_string(bytes);
+        bench::add("buffer/copy" + suffix, [bytes](size_t iterations) {
+            Buffer source(bytes);
+            for (size_t i = 0; i < iterations; ++i) {
+                Buffer copy(source);
+                bench::do_not_optimize(copy);
+            }
+        });
+        bench::add("buffer/move" + suffix, [bytes](size_t iterations) {
+            Buffer a(bytes);
+            for (size_t i = 0; i < iterations; ++i) {
+                Buffer b(std::move(a));
+                bench::do_not_optimize(b);
+                a = std::move(b);
+            }
+        });
+    }
+    return true;
+}();
+
+}  // namespace
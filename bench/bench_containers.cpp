@@ -0,0 +1,138 @@
+// Exercises 3 and 5: ThreadSafeQueue push/pop by thread count, and
+// FixedArray iteration against a raw array. Exercise 5 includes exercise
+// 3, so both are benchmarked from this one translation unit.
+#define EXERCISE_5_NO_MAIN
+#include "exercise_5_solution.cpp"
+
+#include <numeric>
+
+#include "harness.h"
+
+namespace {
+
+// One operation is one item pushed and popped. A single thread alternates
+// push and pop; otherwise half the threads produce and half consume, each
+// consumer popping an exact share so every run drains the queue. The queue
+// and the threads are created on the first run and reused after that.
+template<typename Stats = NoQueueStats, typename Order = FifoOrder>
+class QueueRoundTrip {
+public:
+    explicit QueueRoundTrip(size_t threads) : threads_(threads) {}
+
+    void operator()(size_t iterations) {
+        if (!queue_) {
+            queue_ = std::make_unique<ThreadSafeQueue<int, Stats, Order>>();
+        }
+        auto& queue = *queue_;
+        if (threads_ == 1) {
+            for (size_t i = 0; i < iterations; ++i) {
+                queue.push(static_cast<int>(i));
+                bench::do_not_optimize(queue.pop());
+            }
+            return;
+        }
+
+        if (!team_) {
+            team_ = std::make_unique<bench::ThreadTeam>(threads_);
+        }
+        size_t producers = threads_ / 2;
+        size_t consumers = threads_ - producers;
+        auto share = [iterations](size_t index, size_t parts) {
+            return iterations / parts + (index < iterations % parts ? 1 : 0);
+        };
+        team_->run([&](size_t index) {
+            if (index < producers) {
+                for (size_t i = 0, count = share(index, producers); i < count; ++i) {
+                    queue.push(static_cast<int>(i));
+                }
+            } else {
+                for (size_t i = 0, count = share(index - producers, consumers); i < count; ++i) {
+                    bench::do_not_optimize(queue.pop());
+                }
+            }
+        });
+    }
+
+private:
+    size_t threads_;
+    std::unique_ptr<ThreadSafeQueue<int, Stats, Order>> queue_;
+    std::unique_ptr<bench::ThreadTeam> team_;
+};
+
+// bench::Function must be copyable; the fixture stays shared across copies
+template<typename Stats = NoQueueStats, typename Order = FifoOrder>
+bench::Function queue_round_trip(size_t threads) {
+    auto fixture = std::make_shared<QueueRoundTrip<Stats, Order>>(threads);
+    return [fixture](size_t iterations) { (*fixture)(iterations); };
+}
+
+const bool queue_registered = [] {
+    for (size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+        bench::add("thread_safe_queue/push+pop/threads:" + std::to_string(threads),
+                   queue_round_trip(threads));
+    }
+    // Cost of the opt-in instrumentation (timestamps, lock timing, histogram)
+    for (size_t threads : {1, 4}) {
+        bench::add("thread_safe_queue_stats/push+pop/threads:" + std::to_string(threads),
+                   queue_round_trip<QueueStats>(threads));
+    }
+    // 4-ary heap storage instead of FIFO order
+    for (size_t threads : {1, 4}) {
+        bench::add("thread_safe_queue_priority/push+pop/threads:" + std::to_string(threads),
+                   queue_round_trip<NoQueueStats, PriorityOrder<4, std::less<>>>(threads));
+    }
+    return true;
+}();
+
+// One operation is one element visited. The arrays are filled once, when
+// first used, rather than on every run. They are not const, so
+// clobber_memory() still forces each sweep to reload the elements.
+constexpr size_t elements = 4096;
+
+int* raw_array() {
+    static int raw[elements];
+    static const bool filled = (std::iota(raw, raw + elements, 0), true);
+    (void)filled;
+    return raw;
+}
+
+FixedArray<int, elements>& fixed_array() {
+    static FixedArray<int, elements> array = [] {
+        FixedArray<int, elements> filled;
+        std::iota(filled.begin(), filled.end(), 0);
+        return filled;
+    }();
+    return array;
+}
+
+BENCH_REGISTER("fixed_array/iterate/raw_array", [](size_t iterations) {
+    int* raw = raw_array();
+    long sum = 0;
+    for (size_t done = 0; done < iterations; done += elements) {
+        for (size_t i = 0; i < elements; ++i) {
+            sum += raw[i];
+        }
+        bench::do_not_optimize(sum);
+    }
+});
+
+BENCH_REGISTER("fixed_array/iterate/FixedArray", [](size_t iterations) {
+    auto& array = fixed_array();
+    long sum = 0;
+    for (size_t done = 0; done < iterations; done += elements) {
+        for (int value : array) {
+            sum += value;
+        }
+        bench::do_not_optimize(sum);
+    }
+});
+
+BENCH_REGISTER("fixed_array/iterate/FixedArray::sum", [](size_t iterations) {
+    auto& array = fixed_array();
+    for (size_t done = 0; done < iterations; done += elements) {
+        bench::do_not_optimize(array.sum());
+        bench::clobber_memory();
+    }
+});
+
+}  // namespace
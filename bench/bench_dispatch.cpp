@@ -0,0 +1,70 @@
+// Exercise 6: virtual dispatch through Animal* against AnimalSet's static
+// dispatch. The timed call is energyNeed(), which is pure arithmetic, so
+// the comparison is not swamped by stream formatting. The herd is built
+// once, outside the timed runs. One operation is one animal visited; runs
+// are whole sweeps over the herd.
+#define EXERCISE_6_NO_MAIN
+#include "exercise_6_solution.cpp"
+
+#include "harness.h"
+
+namespace {
+
+constexpr size_t per_species = 1000;
+
+const std::vector<std::unique_ptr<Animal>>& zoo() {
+    static const std::vector<std::unique_ptr<Animal>> animals = [] {
+        std::vector<std::unique_ptr<Animal>> herd;
+        for (size_t i = 0; i < per_species; ++i) {
+            herd.push_back(std::make_unique<Mammal>("Mouse"));
+            herd.push_back(std::make_unique<Bat>("Bat"));
+            herd.push_back(std::make_unique<AdvancedBat>("Hunter"));
+        }
+        return herd;
+    }();
+    return animals;
+}
+
+const AnimalSet<Mammal, Bat, AdvancedBat>& animal_set() {
+    static const AnimalSet<Mammal, Bat, AdvancedBat> animals = [] {
+        AnimalSet<Mammal, Bat, AdvancedBat> herd;
+        for (size_t i = 0; i < per_species; ++i) {
+            herd.emplace<Mammal>("Mouse");
+            herd.emplace<Bat>("Bat");
+            herd.emplace<AdvancedBat>("Hunter");
+        }
+        return herd;
+    }();
+    return animals;
+}
+
+BENCH_REGISTER("dispatch/energyNeed/virtual", [](size_t iterations) {
+    const auto& animals = zoo();
+    for (size_t done = 0; done < iterations; done += animals.size()) {
+        // Varying the argument keeps the calls from being hoisted
+        int hours = static_cast<int>(done & 7) + 1;
+        bench::do_not_optimize(hours);
+        int total = 0;
+        for (const auto& animal : animals) {
+            total += animal->energyNeed(hours);
+        }
+        bench::do_not_optimize(total);
+    }
+});
+
+BENCH_REGISTER("dispatch/energyNeed/static", [](size_t iterations) {
+    const auto& animals = animal_set();
+    for (size_t done = 0; done < iterations; done += animals.size()) {
+        int hours = static_cast<int>(done & 7) + 1;
+        bench::do_not_optimize(hours);
+        int total = 0;
+        animals.forEach([hours, &total](const auto& animal) {
+            // Qualified call: the concrete type is known, so no vtable load
+            using T = std::decay_t<decltype(animal)>;
+            total += animal.T::energyNeed(hours);
+        });
+        bench::do_not_optimize(total);
+    }
+});
+
+}  // namespace
@@ -0,0 +1,7 @@
+// Benchmark suite entry point. Each bench_*.cpp registers its benchmarks
+// at static initialization; run with --json=<path> to record results.
+#include "harness.h"
+
+int main(int argc, char* argv[]) {
+    return bench::run_all(argc, argv);
+}
@@ -0,0 +1,52 @@
+// Exercise 1: UniquePtr against std::unique_ptr
+#define EXERCISE_1_NO_MAIN
+#include "exercise_1_solution.cpp"
+
+#include <memory>
+
+#include "harness.h"
+
+namespace {
+
+struct Payload {
+    int value;
+    explicit Payload(int v) : value(v) {}
+};
+
+BENCH_REGISTER("unique_ptr/make+destroy/UniquePtr", [](size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+        auto ptr = ::make_unique<Payload>(static_cast<int>(i));
+        bench::do_not_optimize(ptr.get());
+    }
+});
+
+BENCH_REGISTER("unique_ptr/make+destroy/std::unique_ptr", [](size_t iterations) {
+    for (size_t i = 0; i < iterations; ++i) {
+        auto ptr = std::make_unique<Payload>(static_cast<int>(i));
+        bench::do_not_optimize(ptr.get());
+    }
+});
+
+BENCH_REGISTER("unique_ptr/move+deref/UniquePtr", [](size_t iterations) {
+    auto ptr = ::make_unique<Payload>(1);
+    long sum = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        UniquePtr<Payload> moved = std::move(ptr);
+        sum += moved->value;
+        ptr = std::move(moved);
+        bench::do_not_optimize(sum);
+    }
+});
+
+BENCH_REGISTER("unique_ptr/move+deref/std::unique_ptr", [](size_t iterations) {
+    auto ptr = std::make_unique<Payload>(1);
+    long sum = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        std::unique_ptr<Payload> moved = std::move(ptr);
+        sum += moved->value;
+        ptr = std::move(moved);
+        bench::do_not_optimize(sum);
+    }
+});
+
+}  // namespace
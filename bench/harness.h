@@ -0,0 +1,287 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+// Minimal benchmark harness for the exercises.
+//
+// A benchmark is a function that performs a given number of operations;
+// the harness calibrates that number until one run takes at least
+// --min-time seconds, repeats the run --repetitions times and reports the
+// median, minimum and maximum time per operation. Results are printed as a
+// table and, with --json=<path>, written in the same shape as Google
+// Benchmark's JSON output ({"context": ..., "benchmarks": [...]}) so the
+// usual comparison tooling can track them over time.
+//
+// Setup belongs outside run(iterations): build fixtures once (a function-
+// local static, or state captured by the registered lambda) so the timed
+// region holds only the operations being counted. Multi-threaded
+// benchmarks reuse a ThreadTeam instead of spawning threads per run.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// Runs exactly `iterations` operations
+using Function = std::function<void(size_t iterations)>;
+
+struct Benchmark {
+    std::string name;
+    Function run;
+};
+
+inline std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+inline void add(std::string name, Function run) {
+    registry().push_back(Benchmark{std::move(name), std::move(run)});
+}
+
+// Static registration: BENCH_REGISTER("name", fn) at namespace scope
+struct Registrar {
+    Registrar(std::string name, Function run) { add(std::move(name), std::move(run)); }
+};
+
+#define BENCH_CONCAT_IMPL(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_IMPL(a, b)
+#define BENCH_REGISTER(name, ...) \
+    static const ::bench::Registrar BENCH_CONCAT(bench_registrar_, __LINE__)(name, __VA_ARGS__)
+
+// Keeps the compiler from discarding a value or the work that produced it
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Forces pending stores to be treated as observable
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+// A fixed set of threads started once and reused across runs, so thread
+// creation and joining stay out of the timed region. run(task) calls
+// task(index) on every thread and returns when all of them have finished.
+class ThreadTeam {
+public:
+    using Task = std::function<void(size_t index)>;
+
+    explicit ThreadTeam(size_t size) {
+        for (size_t index = 0; index < size; ++index) {
+            threads_.emplace_back([this, index] { work(index); });
+        }
+    }
+
+    ~ThreadTeam() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        start_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    ThreadTeam(const ThreadTeam&) = delete;
+    ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+    size_t size() const { return threads_.size(); }
+
+    void run(const Task& task) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        task_ = &task;
+        remaining_ = threads_.size();
+        ++generation_;
+        start_.notify_all();
+        done_.wait(lock, [this] { return remaining_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+    void work(size_t index) {
+        size_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            start_.wait(lock, [this, seen] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            const Task& task = *task_;
+            lock.unlock();
+            task(index);
+            lock.lock();
+            if (--remaining_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const Task* task_ = nullptr;
+    size_t generation_ = 0;
+    size_t remaining_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+struct Options {
+    double min_time = 0.2;  // Seconds per timed run
+    size_t repetitions = 5;
+    std::string filter;     // Substring a benchmark name must contain
+    std::string json_path;
+};
+
+struct Result {
+    std::string name;
+    size_t iterations;
+    size_t repetitions;
+    double median_ns;
+    double min_ns;
+    double max_ns;
+};
+
+inline double seconds_for(const Benchmark& benchmark, size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    benchmark.run(iterations);
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+inline Result measure(const Benchmark& benchmark, const Options& options) {
+    // Untimed first run: builds lazily created fixtures and warms caches
+    benchmark.run(1);
+
+    // Grow the operation count until one run is long enough to time
+    size_t iterations = 1;
+    for (;;) {
+        double elapsed = seconds_for(benchmark, iterations);
+        if (elapsed >= options.min_time || iterations >= (size_t{1} << 34)) {
+            break;
+        }
+        double scale = elapsed > 0 ? options.min_time / elapsed * 1.2 : 10.0;
+        scale = std::min(std::max(scale, 1.5), 10.0);
+        iterations = static_cast<size_t>(static_cast<double>(iterations) * scale) + 1;
+    }
+
+    std::vector<double> ns_per_op;
+    for (size_t rep = 0; rep < options.repetitions; ++rep) {
+        ns_per_op.push_back(seconds_for(benchmark, iterations) * 1e9 / static_cast<double>(iterations));
+    }
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+    return Result{benchmark.name, iterations, ns_per_op.size(), ns_per_op[ns_per_op.size() / 2],
+                  ns_per_op.front(), ns_per_op.back()};
+}
+
+inline std::string json_escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+inline void write_json(std::ostream& out, const std::vector<Result>& results, const char* executable) {
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n  \"context\": {\n"
+        << "    \"date\": \"" << date << "\",\n"
+        << "    \"executable\": \"" << json_escape(executable) << "\",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef __VERSION__
+        << "    \"compiler\": \"" << json_escape(__VERSION__) << "\",\n"
+#endif
+#ifdef NDEBUG
+        << "    \"library_build_type\": \"release\"\n"
+#else
+        << "    \"library_build_type\": \"debug\"\n"
+#endif
+        << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": \"" << json_escape(r.name) << "\", \"iterations\": " << r.iterations
+            << ", \"repetitions\": " << r.repetitions << ", \"real_time\": " << r.median_ns
+            << ", \"min_time\": " << r.min_ns << ", \"max_time\": " << r.max_ns << ", \"time_unit\": \"ns\"}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+inline Options parse_options(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&arg](const char* prefix) { return arg.substr(std::char_traits<char>::length(prefix)); };
+        if (arg.rfind("--json=", 0) == 0) {
+            options.json_path = value("--json=");
+        } else if (arg.rfind("--filter=", 0) == 0) {
+            options.filter = value("--filter=");
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            options.min_time = std::stod(value("--min-time="));
+        } else if (arg.rfind("--repetitions=", 0) == 0) {
+            options.repetitions = std::max<size_t>(1, std::stoul(value("--repetitions=")));
+        } else {
+            throw std::invalid_argument("unknown option: " + arg +
+                                        " (expected --json=, --filter=, --min-time=, --repetitions=)");
+        }
+    }
+    return options;
+}
+
+// Runs every registered benchmark matching the filter; returns an exit code
+inline int run_all(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "bench: " << e.what() << "\n";
+        return 2;
+    }
+
+    std::vector<Result> results;
+    std::printf("%-48s %14s %12s %12s %12s\n", "benchmark", "iterations", "ns/op", "min", "max");
+    for (const Benchmark& benchmark : registry()) {
+        if (benchmark.name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        Result result = measure(benchmark, options);
+        std::printf("%-48s %14zu %12.2f %12.2f %12.2f\n", result.name.c_str(), result.iterations, result.median_ns,
+                    result.min_ns, result.max_ns);
+        std::fflush(stdout);
+        results.push_back(std::move(result));
+    }
+
+    if (!options.json_path.empty()) {
+        std::ofstream out(options.json_path);
+        if (!out) {
+            std::cerr << "bench: cannot write " << options.json_path << "\n";
+            return 1;
+        }
+        write_json(out, results, argv[0]);
+    }
+    return 0;
+}
+
+}  // namespace bench
+
+#endif  // BENCH_HARNESS_H
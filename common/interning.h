@@ -0,0 +1,100 @@
+#ifndef COMMON_INTERNING_H
+#define COMMON_INTERNING_H
+
+// Interned names shared by the exercises: a process-wide NameTable and the
+// 4-byte InternedName handle that objects store instead of a std::string.
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Process-wide string pool: every distinct name is stored once and objects
+// keep a 4-byte id. Interning a name that is already known only takes a
+// shared lock and a hash lookup (no allocation), so objects can be built
+// concurrently from many threads.
+class NameTable {
+public:
+    using Id = uint32_t;
+
+private:
+    std::shared_mutex mutex_;
+    std::deque<std::string> names_;  // Deque: elements never move, so views stay valid
+    std::unordered_map<std::string_view, Id> ids_;
+
+    static NameTable& instance() {
+        static NameTable table;
+        return table;
+    }
+
+    Id find_or_add(std::string_view name) {
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            auto it = ids_.find(name);
+            if (it != ids_.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(name);  // Another thread may have added it meanwhile
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        Id id = static_cast<Id>(names_.size());
+        names_.emplace_back(name);
+        ids_.emplace(names_.back(), id);
+        return id;
+    }
+
+public:
+    static Id intern(std::string_view name) {
+        return instance().find_or_add(name);
+    }
+
+    // Interns name + suffix without building a temporary string per call:
+    // the key is assembled in a per-thread buffer that keeps its capacity
+    static Id intern(std::string_view name, std::string_view suffix) {
+        thread_local std::string key;
+        key.assign(name.data(), name.size());
+        key.append(suffix.data(), suffix.size());
+        return instance().find_or_add(key);
+    }
+
+    static const std::string& lookup(Id id) {
+        NameTable& table = instance();
+        std::shared_lock<std::shared_mutex> lock(table.mutex_);
+        return table.names_[id];
+    }
+
+    static size_t size() {
+        NameTable& table = instance();
+        std::shared_lock<std::shared_mutex> lock(table.mutex_);
+        return table.names_.size();
+    }
+};
+
+// A name stored as its NameTable id; trivially copyable, 4 bytes
+class InternedName {
+private:
+    NameTable::Id id_;
+
+public:
+    explicit InternedName(std::string_view name) : id_(NameTable::intern(name)) {}
+    InternedName(std::string_view name, std::string_view suffix) : id_(NameTable::intern(name, suffix)) {}
+
+    const std::string& str() const { return NameTable::lookup(id_); }
+    NameTable::Id id() const { return id_; }
+
+    friend bool operator==(InternedName a, InternedName b) { return a.id_ == b.id_; }
+    friend bool operator!=(InternedName a, InternedName b) { return a.id_ != b.id_; }
+
+    friend std::ostream& operator<<(std::ostream& os, InternedName name) {
+        return os << name.str();
+    }
+};
+
+#endif  // COMMON_INTERNING_H
@@ -0,0 +1,240 @@
+#ifndef COMMON_LAYOUT_H
+#define COMMON_LAYOUT_H
+
+// Object layout reporting shared by the exercises: LayoutReport measures a
+// class hierarchy from the members and bases that LayoutMembers lists for
+// it, and write_layout_json prints the reports for CI to diff. SilenceCout
+// lets constructors that print be run quietly while measuring.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// What LayoutReport needs to know about a class's own layout: its direct
+// bases and the data members it declares. The primary template describes a
+// class with neither; classes that have either specialize it (and befriend
+// the specialization so it can reach non-public members).
+template<typename T>
+struct LayoutMembers {
+    using bases = std::tuple<>;
+
+    template<typename Visitor>
+    static void members(const T&, Visitor&) {}
+};
+
+// Discards everything written to it, so objects can be built and timed
+// without terminal I/O
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// Redirects std::cout into a NullBuffer for the lifetime of the guard
+class SilenceCout {
+private:
+    NullBuffer null_;
+    std::streambuf* saved_;
+
+public:
+    SilenceCout() : saved_(std::cout.rdbuf(&null_)) {}
+    ~SilenceCout() { std::cout.rdbuf(saved_); }
+
+    SilenceCout(const SilenceCout&) = delete;
+    SilenceCout& operator=(const SilenceCout&) = delete;
+};
+
+// Layout of one class: size, alignment, where each listed base subobject
+// starts, how many vtable pointers an object carries and how many of its
+// bytes are padding.
+//
+// Everything is derived from addresses and sizes, never from the bytes a
+// constructor happens to write: starting from T, LayoutMembers names each
+// class's data members and direct bases, so the report walks every
+// subobject (virtual bases included, through a live object) and marks the
+// bytes its vptr and members occupy. Bytes left unmarked are padding, and
+// each is charged to the listed subobject whose address range (its start
+// up to the next subobject) contains it. A class with data members but no
+// LayoutMembers specialization would have them reported as padding.
+//
+// Under the Itanium C++ ABI (GCC, Clang) every dynamic subobject begins
+// with a vptr that its primary base shares, so the vptrs are the distinct
+// start addresses of dynamic subobjects. The same ABI keeps virtual base
+// offsets in the vtable, so objects carry no separate virtual base
+// pointers.
+class LayoutReport {
+public:
+    struct Subobject {
+        std::string name;
+        size_t offset;
+        size_t extent;          // Bytes up to the next subobject start (0 if shared)
+        bool vptr;              // A vtable pointer starts here
+        size_t padding_bytes;
+    };
+
+private:
+    std::string name_;
+    size_t size_ = 0;
+    size_t alignment_ = 0;
+    size_t vptr_count_ = 0;
+    std::vector<Subobject> subobjects_;
+
+    // Which bytes of the complete object hold a vptr or a data member
+    struct Footprint {
+        const unsigned char* start;
+        std::vector<bool> used;
+        std::vector<size_t> vptrs;  // Offsets of distinct vptrs
+
+        size_t offset(const void* address) const {
+            return static_cast<size_t>(static_cast<const unsigned char*>(address) - start);
+        }
+
+        void mark(const void* address, size_t size) {
+            size_t first = offset(address);
+            if (first + size > used.size()) {
+                throw std::logic_error("LayoutReport: member outside the object");
+            }
+            std::fill(used.begin() + static_cast<std::ptrdiff_t>(first),
+                      used.begin() + static_cast<std::ptrdiff_t>(first + size), true);
+        }
+    };
+
+    template<typename X>
+    static void trace(const X& object, Footprint& footprint) {
+        if constexpr (std::is_polymorphic_v<X>) {
+            footprint.mark(&object, sizeof(void*));
+            size_t at = footprint.offset(&object);
+            if (std::find(footprint.vptrs.begin(), footprint.vptrs.end(), at) == footprint.vptrs.end()) {
+                footprint.vptrs.push_back(at);
+            }
+        }
+        auto member = [&footprint](const auto& field) { footprint.mark(&field, sizeof(field)); };
+        LayoutMembers<X>::members(object, member);
+        trace_bases(object, footprint, static_cast<typename LayoutMembers<X>::bases*>(nullptr));
+    }
+
+    template<typename X, typename... Bases>
+    static void trace_bases(const X& object, Footprint& footprint, std::tuple<Bases...>*) {
+        (trace<Bases>(static_cast<const Bases&>(object), footprint), ...);
+    }
+
+    template<typename Base, typename T>
+    static size_t offset_of(const T* object) {
+        return static_cast<size_t>(reinterpret_cast<const unsigned char*>(static_cast<const Base*>(object)) -
+                                   reinterpret_cast<const unsigned char*>(object));
+    }
+
+public:
+    // Measures T. make(void* storage) must placement-construct a T there and
+    // return it (only addresses are read, so any constructor will do);
+    // base_names label Bases in the order they are listed.
+    template<typename T, typename... Bases, typename Factory>
+    static LayoutReport measure(std::string name, const std::array<const char*, sizeof...(Bases)>& base_names,
+                                Factory make) {
+        static_assert((std::is_base_of_v<Bases, T> && ...), "every listed type must be a base of T");
+
+        struct Entry {
+            std::string name;
+            size_t offset;
+        };
+        std::vector<Entry> entries{{name, 0}};
+        Footprint footprint;
+        {
+            alignas(T) unsigned char storage[sizeof(T)];
+            T* object = make(static_cast<void*>(storage));
+            footprint.start = storage;
+            footprint.used.assign(sizeof(T), false);
+            trace(*object, footprint);
+            size_t index = 0;
+            (entries.push_back(Entry{base_names[index++], offset_of<Bases>(object)}), ...);
+            object->~T();
+        }
+        std::stable_sort(entries.begin(), entries.end(),
+                         [](const Entry& a, const Entry& b) { return a.offset < b.offset; });
+
+        LayoutReport report;
+        report.name_ = std::move(name);
+        report.size_ = sizeof(T);
+        report.alignment_ = alignof(T);
+        report.vptr_count_ = footprint.vptrs.size();
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const Entry& entry = entries[i];
+            bool shared = i > 0 && entries[i - 1].offset == entry.offset;
+            size_t end = sizeof(T);
+            for (size_t j = i + 1; j < entries.size(); ++j) {
+                if (entries[j].offset > entry.offset) {
+                    end = entries[j].offset;
+                    break;
+                }
+            }
+
+            Subobject sub{entry.name, entry.offset, shared ? 0 : end - entry.offset, false, 0};
+            if (!shared) {
+                sub.vptr = std::find(footprint.vptrs.begin(), footprint.vptrs.end(), entry.offset) !=
+                           footprint.vptrs.end();
+                for (size_t b = entry.offset; b < end; ++b) {
+                    sub.padding_bytes += !footprint.used[b];
+                }
+            }
+            report.subobjects_.push_back(std::move(sub));
+        }
+        return report;
+    }
+
+    const std::string& name() const { return name_; }
+    size_t size() const { return size_; }
+    size_t alignment() const { return alignment_; }
+    const std::vector<Subobject>& subobjects() const { return subobjects_; }
+
+    size_t vptr_count() const { return vptr_count_; }
+
+    size_t padding_bytes() const {
+        size_t total = 0;
+        for (const Subobject& sub : subobjects_) {
+            total += sub.padding_bytes;
+        }
+        return total;
+    }
+
+    // Bytes per object spent on vtable pointers and padding rather than
+    // on data members
+    size_t overhead_bytes() const {
+        return vptr_count() * sizeof(void*) + padding_bytes();
+    }
+
+    // One JSON object; totals are for `instances` objects stored contiguously
+    std::string to_json(size_t instances) const {
+        std::ostringstream json;
+        json << "{\"type\":\"" << name_ << "\",\"sizeof\":" << size_ << ",\"alignof\":" << alignment_
+             << ",\"vptrs\":" << vptr_count() << ",\"padding_bytes\":" << padding_bytes() << ",\"subobjects\":[";
+        for (size_t i = 0; i < subobjects_.size(); ++i) {
+            const Subobject& sub = subobjects_[i];
+            json << (i ? "," : "") << "{\"name\":\"" << sub.name << "\",\"offset\":" << sub.offset
+                 << ",\"extent\":" << sub.extent << ",\"vptr\":" << (sub.vptr ? "true" : "false")
+                 << ",\"padding_bytes\":" << sub.padding_bytes << "}";
+        }
+        json << "],\"instances\":" << instances << ",\"total_bytes\":" << instances * size_
+             << ",\"overhead_bytes\":" << instances * overhead_bytes() << "}";
+        return json.str();
+    }
+};
+
+// Writes {"instances": N, "layouts": [...]} for CI to diff against a baseline
+inline void write_layout_json(std::ostream& out, const std::vector<LayoutReport>& reports, size_t instances) {
+    out << "{\"instances\":" << instances << ",\"layouts\":[";
+    for (size_t i = 0; i < reports.size(); ++i) {
+        out << (i ? ",\n  " : "\n  ") << reports[i].to_json(instances);
+    }
+    out << "\n]}\n";
+}
+
+#endif  // COMMON_LAYOUT_H
@@ -0,0 +1,97 @@
+#ifndef COMMON_SHARDED_COUNTER_H
+#define COMMON_SHARDED_COUNTER_H
+
+// Contention-free counting shared by the exercises: ShardedCounter, and the
+// cache_line_size it (and other lock-free structures) pad atomics to.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// Cache line size used to keep independently written atomics apart
+#ifdef __cpp_lib_hardware_interference_size
+// GCC warns that the value may vary with -mtune when a header uses it; it
+// only sizes padding inside one program, so that is fine
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+constexpr size_t cache_line_size = std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+constexpr size_t cache_line_size = 64;
+#endif
+
+// Each thread is assigned one of a fixed set of shards on first use, so
+// concurrent increments from different threads land on different cache
+// lines. Every flush_interval counts a shard also publishes to a shared
+// approximate total, which makes get() a single load that lags the true
+// value by less than flush_interval per shard. sum() walks all shards and
+// is exact once writers are quiescent. Decrements may come from a
+// different thread than the matching increment (an object destroyed on
+// another thread), so a shard can go negative; the bounds are unchanged.
+class ShardedCounter {
+public:
+    static constexpr size_t shard_count = 64;
+    static constexpr int64_t flush_interval = 64;
+
+private:
+    struct alignas(cache_line_size) Shard {
+        std::atomic<int64_t> value{0};
+    };
+
+    Shard shards_[shard_count];
+    alignas(cache_line_size) std::atomic<int64_t> approximate_{0};
+
+    static inline std::atomic<size_t> next_shard_{0};
+
+    static size_t shard_index() {
+        static thread_local size_t index = next_shard_.fetch_add(1, std::memory_order_relaxed) % shard_count;
+        return index;
+    }
+
+public:
+    ShardedCounter() = default;
+
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void increment(int64_t amount = 1) {
+        int64_t old = shards_[shard_index()].value.fetch_add(amount, std::memory_order_relaxed);
+        int64_t crossed = (old + amount) / flush_interval - old / flush_interval;
+        if (crossed != 0) {
+            approximate_.fetch_add(crossed * flush_interval, std::memory_order_relaxed);
+        }
+    }
+
+    void decrement(int64_t amount = 1) {
+        increment(-amount);
+    }
+
+    // Cheap approximate value (one shared load, may lag behind sum())
+    int64_t get() const {
+        return approximate_.load(std::memory_order_relaxed);
+    }
+
+    // Exact value (reads every shard)
+    int64_t sum() const {
+        int64_t total = 0;
+        for (const auto& shard : shards_) {
+            total += shard.value.load(std::memory_order_acquire);
+        }
+        return total;
+    }
+
+    // Not atomic with respect to concurrent increments
+    void reset() {
+        for (auto& shard : shards_) {
+            shard.value.store(0, std::memory_order_relaxed);
+        }
+        approximate_.store(0, std::memory_order_relaxed);
+    }
+};
+
+#endif  // COMMON_SHARDED_COUNTER_H
@@ -0,0 +1,265 @@
+#ifndef COMMON_TRACING_H
+#define COMMON_TRACING_H
+
+// Lifecycle tracing shared by the exercises.
+//
+// TRACE_INFO(...) and TRACE_DEBUG(...) format their arguments with
+// operator<< into one line. The level is a compile-time constant: calls
+// above TRACE_LEVEL sit in a discarded `if constexpr` branch, arguments
+// included, so with -DTRACE_LEVEL=0 no trace code or string survives.
+//
+//   TRACE_LEVEL 0  off
+//               1  error
+//               2  info   (construction, destruction, resource open/close)
+//               3  debug  (copies, moves, per-operation detail; default)
+//
+// By default a line goes straight to std::cout (with '\n', never a flush),
+// so the exercise programs print exactly what they always have. While a
+// tracing::AsyncSink is alive, lines are instead written into a lock-free
+// ring owned by the calling thread and a background thread drains every
+// ring to the sink's stream. The hot path is then a format into a fixed
+// slot plus one release store; a full ring drops the line (and counts it)
+// rather than block. Lines from one thread keep their order; lines from
+// different threads are interleaved in drain order.
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 3
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace tracing {
+
+enum class Level : int { off = 0, error = 1, info = 2, debug = 3 };
+
+template<Level L>
+inline constexpr bool enabled = L != Level::off && static_cast<int>(L) <= TRACE_LEVEL;
+
+namespace detail {
+
+// One formatted line; longer lines are truncated
+struct Record {
+    static constexpr size_t capacity = 124;
+    uint32_t length;
+    char text[capacity];
+};
+
+// Single-producer (the owning thread), single-consumer (the drain) ring
+class Ring {
+public:
+    static constexpr size_t slots = 512;  // Power of two
+
+private:
+    Record records_[slots];
+    alignas(64) std::atomic<size_t> head_{0};  // Next slot to write
+    alignas(64) std::atomic<size_t> tail_{0};  // Next slot to read
+    std::atomic<size_t> dropped_{0};
+
+public:
+    // Slot for the next line, or nullptr (and a drop) if the ring is full
+    Record* begin_write() noexcept {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == slots) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return &records_[head & (slots - 1)];
+    }
+
+    void commit() noexcept {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    template<typename Sink>
+    void drain(Sink&& sink) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            sink(records_[tail & (slots - 1)]);
+        }
+        tail_.store(tail, std::memory_order_release);
+    }
+
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+    size_t take_dropped() noexcept { return dropped_.exchange(0, std::memory_order_relaxed); }
+};
+
+// Writes into a caller-supplied buffer and stops (truncates) when it is full
+class FixedStreamBuf : public std::streambuf {
+public:
+    void reset(char* buffer, size_t size) { setp(buffer, buffer + size); }
+    size_t written() const { return static_cast<size_t>(pptr() - pbase()); }
+
+protected:
+    int overflow(int) override { return traits_type::eof(); }
+};
+
+struct State {
+    std::atomic<bool> async{false};
+    std::mutex rings_mutex;  // Guards rings; taken on a thread's first async line, never per line
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::mutex drain_mutex;  // Serializes drains: each ring has a single consumer
+    std::atomic<size_t> dropped{0};
+};
+
+inline State& state() {
+    static State instance;
+    return instance;
+}
+
+// The calling thread's ring and formatter, created on its first async line.
+// The registry shares ownership, so lines left by an exiting thread are
+// still drained.
+struct ThreadWriter {
+    std::shared_ptr<Ring> ring = std::make_shared<Ring>();
+    FixedStreamBuf buffer;
+    std::ostream out{&buffer};
+
+    ThreadWriter() {
+        std::lock_guard<std::mutex> lock(state().rings_mutex);
+        state().rings.push_back(ring);
+    }
+};
+
+inline ThreadWriter& thread_writer() {
+    thread_local ThreadWriter writer;
+    return writer;
+}
+
+template<typename... Args>
+void write(const Args&... args) {
+    if (!state().async.load(std::memory_order_acquire)) {
+        (std::cout << ... << args) << '\n';
+        return;
+    }
+
+    ThreadWriter& writer = thread_writer();
+    Record* record = writer.ring->begin_write();
+    if (!record) {
+        return;
+    }
+    writer.buffer.reset(record->text, Record::capacity);
+    writer.out.clear();
+    (writer.out << ... << args);
+    record->length = static_cast<uint32_t>(writer.buffer.written());
+    writer.ring->commit();
+}
+
+// Drains every ring to out; rings of exited threads are dropped once empty
+inline void drain_all(std::ostream& out) {
+    std::lock_guard<std::mutex> drain_lock(state().drain_mutex);
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(state().rings_mutex);
+        rings = state().rings;
+    }
+    for (const std::shared_ptr<Ring>& ring : rings) {
+        ring->drain([&out](const Record& record) {
+            out.write(record.text, static_cast<std::streamsize>(record.length));
+            out.put('\n');
+        });
+        state().dropped.fetch_add(ring->take_dropped(), std::memory_order_relaxed);
+    }
+    out.flush();
+
+    std::lock_guard<std::mutex> lock(state().rings_mutex);
+    auto& registered = state().rings;
+    for (size_t i = 0; i < registered.size();) {
+        // use_count 2: the registry and the local copy; the owner has exited
+        if (registered[i].use_count() == 2 && registered[i]->empty()) {
+            registered.erase(registered.begin() + static_cast<std::ptrdiff_t>(i));
+        } else {
+            ++i;
+        }
+    }
+}
+
+}  // namespace detail
+
+// Lines dropped because a thread's ring was full
+inline size_t dropped() {
+    return detail::state().dropped.load(std::memory_order_relaxed);
+}
+
+// While alive, trace lines go to per-thread rings that a background thread
+// flushes to `out` every `interval`. Only one sink may be active at a time.
+// Lines a thread writes while the sink is shutting down may stay in its
+// ring until the next sink flushes them.
+class AsyncSink {
+private:
+    std::ostream& out_;
+    std::chrono::milliseconds interval_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread flusher_;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopping_) {
+            wake_.wait_for(lock, interval_, [this] { return stopping_; });
+            lock.unlock();
+            detail::drain_all(out_);
+            lock.lock();
+        }
+    }
+
+public:
+    explicit AsyncSink(std::ostream& out = std::cout,
+                       std::chrono::milliseconds interval = std::chrono::milliseconds(2))
+        : out_(out), interval_(interval) {
+        if (detail::state().async.exchange(true, std::memory_order_acq_rel)) {
+            throw std::logic_error("tracing::AsyncSink is already active");
+        }
+        flusher_ = std::thread([this] { run(); });
+    }
+
+    ~AsyncSink() {
+        detail::state().async.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        flusher_.join();
+        detail::drain_all(out_);
+    }
+
+    AsyncSink(const AsyncSink&) = delete;
+    AsyncSink& operator=(const AsyncSink&) = delete;
+
+    // Drains all rings now, from the calling thread
+    void flush() { detail::drain_all(out_); }
+};
+
+}  // namespace tracing
+
+// The whole call, arguments included, sits in a discarded `if constexpr`
+// branch when its level is compiled out, so nothing is evaluated
+#define TRACE_AT(level, ...)                                  \
+    do {                                                      \
+        if constexpr (::tracing::enabled<level>) {            \
+            ::tracing::detail::write(__VA_ARGS__);            \
+        }                                                     \
+    } while (0)
+
+#define TRACE_ERROR(...) TRACE_AT(::tracing::Level::error, __VA_ARGS__)
+#define TRACE_INFO(...) TRACE_AT(::tracing::Level::info, __VA_ARGS__)
+#define TRACE_DEBUG(...) TRACE_AT(::tracing::Level::debug, __VA_ARGS__)
+
+#endif  // COMMON_TRACING_H
@@ -0,0 +1,307 @@
+#ifndef COMMON_TRACKING_H
+#define COMMON_TRACKING_H
+
+// Copy/move and allocation tracking shared by the exercises.
+//
+// Counts copies, moves, heap allocations and allocated bytes per call site.
+// A call site is a named static tracking::CallSite; a tracking::Scope makes
+// it the current site of the calling thread, and every event on that
+// thread is charged to it until the scope ends (scopes nest). Events
+// outside any scope go to the shared "<untracked>" site.
+//
+// Per-site counts are thread-local plain integers (no atomics, no locks on
+// the hot path) and are folded into process totals when the thread exits;
+// the totals are printed to stderr at program exit. Scope::counts() reads
+// the calling thread's counts since the scope opened, which is what a test
+// asserts on ("zero copies, zero allocations on this path").
+//
+// Copies and moves are seen by types built on tracking::CountCopies (a
+// mixin base) or wrapped in tracking::Tracked<T>. Allocations are seen
+// through the replaced global operator new/delete below; define
+// TRACKING_NO_ALLOCATION_HOOKS in all but one translation unit when
+// several include this file into one program (the bench does).
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace tracking {
+
+constexpr size_t max_sites = 64;
+
+enum class Event : size_t {
+    copy_construction,
+    copy_assignment,
+    move_construction,
+    move_assignment,
+    allocation,
+    deallocation,
+    bytes_allocated,
+    count
+};
+
+constexpr size_t event_count = static_cast<size_t>(Event::count);
+
+struct Counts {
+    uint64_t events[event_count] = {};
+
+    uint64_t operator[](Event event) const { return events[static_cast<size_t>(event)]; }
+
+    uint64_t copies() const { return (*this)[Event::copy_construction] + (*this)[Event::copy_assignment]; }
+    uint64_t moves() const { return (*this)[Event::move_construction] + (*this)[Event::move_assignment]; }
+    uint64_t allocations() const { return (*this)[Event::allocation]; }
+    uint64_t bytes() const { return (*this)[Event::bytes_allocated]; }
+
+    Counts operator-(const Counts& earlier) const {
+        Counts delta;
+        for (size_t i = 0; i < event_count; ++i) {
+            delta.events[i] = events[i] - earlier.events[i];
+        }
+        return delta;
+    }
+};
+
+namespace detail {
+
+inline std::atomic<size_t> site_count{1};  // Site 0 is "<untracked>"
+inline const char* site_names[max_sites] = {"<untracked>"};
+
+// Process totals; site 0 is updated directly since untracked events can
+// come from threads that never open a scope and so never flush
+inline std::atomic<uint64_t> totals[max_sites][event_count] = {};
+
+// Constant-initialized and trivially destructible, so operator new can
+// touch them without triggering thread_local initialization
+inline thread_local Counts local_counts[max_sites];
+inline thread_local size_t current_site = 0;
+
+inline void record(Event event, uint64_t amount = 1) noexcept {
+    size_t site = current_site;
+    if (site == 0) {
+        totals[0][static_cast<size_t>(event)].fetch_add(amount, std::memory_order_relaxed);
+    } else {
+        local_counts[site].events[static_cast<size_t>(event)] += amount;
+    }
+}
+
+// Folds a thread's per-site counts into the totals when the thread exits
+struct ThreadFlush {
+    ~ThreadFlush() {
+        size_t sites = site_count.load(std::memory_order_acquire);
+        for (size_t site = 1; site < sites && site < max_sites; ++site) {
+            for (size_t i = 0; i < event_count; ++i) {
+                totals[site][i].fetch_add(local_counts[site].events[i], std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+inline thread_local ThreadFlush thread_flush;
+
+// Prints the totals after main() returns (the main thread's thread_local
+// flush runs before static destructors); silent if no site was opened
+struct ExitSummary {
+    ~ExitSummary() {
+        size_t sites = std::min(site_count.load(std::memory_order_acquire), max_sites);
+        if (sites <= 1) {
+            return;
+        }
+        std::fprintf(stderr, "[tracking] %-28s %10s %10s %10s %10s %12s\n", "site", "copies", "moves",
+                     "allocs", "frees", "bytes");
+        for (size_t site = 0; site < sites; ++site) {
+            auto total = [site](Event event) {
+                return static_cast<unsigned long long>(
+                    totals[site][static_cast<size_t>(event)].load(std::memory_order_relaxed));
+            };
+            std::fprintf(stderr, "[tracking] %-28s %10llu %10llu %10llu %10llu %12llu\n", site_names[site],
+                         total(Event::copy_construction) + total(Event::copy_assignment),
+                         total(Event::move_construction) + total(Event::move_assignment),
+                         total(Event::allocation), total(Event::deallocation), total(Event::bytes_allocated));
+        }
+    }
+};
+
+inline ExitSummary exit_summary;
+
+}  // namespace detail
+
+// A named place in the code that events can be charged to. Sites live for
+// the whole program; declare them static (see TRACKING_SITE).
+class CallSite {
+private:
+    size_t id_;
+
+public:
+    explicit CallSite(const char* name) : id_(detail::site_count.fetch_add(1, std::memory_order_acq_rel)) {
+        if (id_ >= max_sites) {
+            throw std::length_error("tracking: too many call sites");
+        }
+        detail::site_names[id_] = name;
+    }
+
+    CallSite(const CallSite&) = delete;
+    CallSite& operator=(const CallSite&) = delete;
+
+    size_t id() const { return id_; }
+    const char* name() const { return detail::site_names[id_]; }
+};
+
+// Charges the calling thread's events to a site for the scope's lifetime
+class Scope {
+private:
+    size_t site_;
+    size_t previous_;
+    Counts start_;
+
+public:
+    explicit Scope(const CallSite& site)
+        : site_(site.id()), previous_(detail::current_site), start_(detail::local_counts[site_]) {
+        (void)&detail::thread_flush;  // Make sure this thread flushes on exit
+        detail::current_site = site_;
+    }
+
+    ~Scope() { detail::current_site = previous_; }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    // This thread's events at the site since the scope opened
+    Counts counts() const { return detail::local_counts[site_] - start_; }
+};
+
+// Mixin: a class that derives from CountCopies and lets its copy/move
+// operations be defaulted (or calls these from its own) reports them
+class CountCopies {
+protected:
+    CountCopies() = default;
+    ~CountCopies() = default;
+
+    CountCopies(const CountCopies&) noexcept { detail::record(Event::copy_construction); }
+    CountCopies(CountCopies&&) noexcept { detail::record(Event::move_construction); }
+
+    CountCopies& operator=(const CountCopies&) noexcept {
+        detail::record(Event::copy_assignment);
+        return *this;
+    }
+
+    CountCopies& operator=(CountCopies&&) noexcept {
+        detail::record(Event::move_assignment);
+        return *this;
+    }
+};
+
+// Wrapper for types that cannot derive from CountCopies (std::string,
+// containers, types from other libraries). Copying or moving a Tracked<T>
+// copies or moves the T and reports it.
+template<typename T>
+class Tracked : private CountCopies {
+private:
+    T value_;
+
+public:
+    Tracked() = default;
+
+    template<typename... Args>
+    explicit Tracked(std::in_place_t, Args&&... args) : value_(std::forward<Args>(args)...) {}
+
+    Tracked(const T& value) : value_(value) {}
+    Tracked(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>) : value_(std::move(value)) {}
+
+    T& get() { return value_; }
+    const T& get() const { return value_; }
+
+    T& operator*() { return value_; }
+    const T& operator*() const { return value_; }
+    T* operator->() { return &value_; }
+    const T* operator->() const { return &value_; }
+};
+
+}  // namespace tracking
+
+// Static site for a string literal, usable right where the scope opens:
+//     tracking::Scope scope(TRACKING_SITE("queue push"));
+#define TRACKING_SITE(label)                                          \
+    ([]() -> const ::tracking::CallSite& {                            \
+        static const ::tracking::CallSite tracking_site_(label);      \
+        return tracking_site_;                                        \
+    }())
+
+#ifndef TRACKING_NO_ALLOCATION_HOOKS
+
+// Global allocation hooks: count, then defer to malloc/free. GCC sees
+// free() on memory from operator new once the replacements are inlined
+// into callers and would warn about a mismatch that is intended here.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    tracking::detail::record(tracking::Event::allocation);
+    tracking::detail::record(tracking::Event::bytes_allocated, size);
+    for (;;) {
+        if (void* block = std::malloc(size ? size : 1)) {
+            return block;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    tracking::detail::record(tracking::Event::allocation);
+    tracking::detail::record(tracking::Event::bytes_allocated, size);
+    size_t align = static_cast<size_t>(alignment);
+    size_t rounded = (size + align - 1) / align * align;  // aligned_alloc needs a multiple
+    for (;;) {
+        if (void* block = std::aligned_alloc(align, rounded ? rounded : align)) {
+            return block;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* block) noexcept {
+    if (block) {
+        tracking::detail::record(tracking::Event::deallocation);
+        std::free(block);
+    }
+}
+
+void operator delete[](void* block) noexcept { ::operator delete(block); }
+void operator delete(void* block, std::size_t) noexcept { ::operator delete(block); }
+void operator delete[](void* block, std::size_t) noexcept { ::operator delete(block); }
+void operator delete(void* block, std::align_val_t) noexcept { ::operator delete(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { ::operator delete(block); }
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept { ::operator delete(block); }
+void operator delete[](void* block, std::size_t, std::align_val_t) noexcept { ::operator delete(block); }
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+#endif  // TRACKING_NO_ALLOCATION_HOOKS
+
+#endif  // COMMON_TRACKING_H